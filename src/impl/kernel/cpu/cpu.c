@@ -0,0 +1,80 @@
+#include "cpu/cpu.h"
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    uint32_t a, b, c, d;
+    asm volatile ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(leaf), "c"(subleaf));
+    if (eax) *eax = a;
+    if (ebx) *ebx = b;
+    if (ecx) *ecx = c;
+    if (edx) *edx = d;
+}
+
+uint64_t rdtsc() {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    asm volatile ("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+void wrmsr(uint32_t msr, uint64_t value) {
+    asm volatile ("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+uint64_t read_cr0() {
+    uint64_t ret;
+    asm volatile ("mov %%cr0, %0" : "=r"(ret));
+    return ret;
+}
+
+void write_cr0(uint64_t value) {
+    asm volatile ("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+uint64_t read_cr2() {
+    uint64_t ret;
+    asm volatile ("mov %%cr2, %0" : "=r"(ret));
+    return ret;
+}
+
+uint64_t read_cr3() {
+    uint64_t ret;
+    asm volatile ("mov %%cr3, %0" : "=r"(ret));
+    return ret;
+}
+
+void write_cr3(uint64_t value) {
+    asm volatile ("mov %0, %%cr3" : : "r"(value) : "memory");
+}
+
+uint64_t read_cr4() {
+    uint64_t ret;
+    asm volatile ("mov %%cr4, %0" : "=r"(ret));
+    return ret;
+}
+
+void write_cr4(uint64_t value) {
+    asm volatile ("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+uint64_t xgetbv(uint32_t index) {
+    uint32_t lo, hi;
+    asm volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+void xsetbv(uint32_t index, uint64_t value) {
+    asm volatile ("xsetbv" : : "c"(index), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+void invlpg(uint64_t addr) {
+    asm volatile ("invlpg (%0)" : : "r"(addr) : "memory");
+}
+
+void wbinvd() {
+    asm volatile ("wbinvd" : : : "memory");
+}
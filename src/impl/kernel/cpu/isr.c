@@ -1,6 +1,11 @@
 #include "cpu/isr.h"
 #include "drivers/vga.h"
 #include "cpu/pic.h"
+#include "cpu/cpu.h"
+#include "drivers/serial.h"
+#include "mm/vmm.h"
+
+#define PAGE_FAULT 14
 
 void (*interrupt_handlers[256])(struct registers*);
 
@@ -8,8 +13,25 @@ void register_interrupt_handler(uint8_t n, void (*handler)(struct registers*)) {
     interrupt_handlers[n] = handler;
 }
 
+// A fault the kernel cannot recover from: report it and stop, since
+// returning would re-execute the faulting instruction forever
+static void page_fault_fatal(struct registers* regs, uint64_t addr) {
+    serial_write_str("panic: page fault at ");
+    serial_write_hex(addr);
+    serial_write_str(" rip ");
+    serial_write_hex(regs->rip);
+    serial_write_str(" err ");
+    serial_write_hex(regs->err_code);
+    serial_write_str("\n");
+    for (;;) asm volatile("cli; hlt");
+}
+
 void isr_handler(struct registers* regs) {
-    if (interrupt_handlers[regs->int_no] != 0) {
+    if (regs->int_no == PAGE_FAULT) {
+        // Demand-zero regions are filled in on first touch
+        uint64_t addr = read_cr2();
+        if (!vmm_handle_fault(addr, regs->err_code)) page_fault_fatal(regs, addr);
+    } else if (interrupt_handlers[regs->int_no] != 0) {
         interrupt_handlers[regs->int_no](regs);
     } else {
         // print_str("Unhandled Exception");
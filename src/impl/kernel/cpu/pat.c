@@ -0,0 +1,49 @@
+#include "cpu/pat.h"
+#include "cpu/cpu.h"
+#include "mm/vmm.h"
+
+#define IA32_PAT_MSR 0x277
+
+// PAT memory types
+#define PAT_UC       0x00
+#define PAT_WC       0x01
+#define PAT_WB       0x06
+#define PAT_UC_MINUS 0x07
+
+static int pat_available = 0;
+
+// Reprogram IA32_PAT so PWT=1 selects write-combining instead of write-through:
+//   PA0=WB PA1=WC PA2=UC- PA3=UC (repeated for PA4-PA7)
+// The boot page tables never set PWT, so existing mappings keep their type.
+int pat_init() {
+    uint32_t edx;
+    cpuid(1, 0, 0, 0, 0, &edx);
+    if (!(edx & (1 << 16))) return 0; // No PAT support
+
+    uint64_t pat = ((uint64_t)PAT_WB)
+                 | ((uint64_t)PAT_WC << 8)
+                 | ((uint64_t)PAT_UC_MINUS << 16)
+                 | ((uint64_t)PAT_UC << 24);
+    pat |= pat << 32;
+
+    wbinvd();
+    wrmsr(IA32_PAT_MSR, pat);
+    wbinvd();
+    write_cr3(read_cr3()); // Flush TLB
+
+    pat_available = 1;
+    return 1;
+}
+
+// Switch the pages covering [phys_addr, phys_addr + size) to write-combining.
+// The range is identity mapped, so the physical address is also the virtual
+// one; huge pages are split only where the range ends inside them.
+void pat_map_write_combining(uint64_t phys_addr, uint64_t size) {
+    if (!pat_available || size == 0) return;
+
+    uint64_t start = phys_addr & ~(VMM_PAGE_SIZE - 1);
+    uint64_t end = (phys_addr + size + VMM_PAGE_SIZE - 1) & ~(VMM_PAGE_SIZE - 1);
+    vmm_set_cache(start, end - start, VMM_CACHE_WC);
+
+    wbinvd();
+}
@@ -0,0 +1,39 @@
+#include "cpu/simd.h"
+#include "cpu/cpu.h"
+
+#define CR0_MP (1ull << 1)
+#define CR0_EM (1ull << 2)
+#define CR4_OSFXSR     (1ull << 9)
+#define CR4_OSXMMEXCPT (1ull << 10)
+#define CR4_OSXSAVE    (1ull << 18)
+
+#define XCR0_X87 (1ull << 0)
+#define XCR0_SSE (1ull << 1)
+#define XCR0_AVX (1ull << 2)
+
+uint32_t simd_features = 0;
+
+void simd_init() {
+    uint32_t max_leaf, ecx, edx, ebx7;
+    cpuid(0, 0, &max_leaf, 0, 0, 0);
+    cpuid(1, 0, 0, 0, &ecx, &edx);
+
+    // SSE/SSE2 are architectural on x86_64, just switch them on
+    write_cr0((read_cr0() & ~CR0_EM) | CR0_MP);
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+    if (edx & (1 << 26)) simd_features |= SIMD_SSE2;
+
+    // AVX needs XSAVE support and the YMM state enabled in XCR0
+    int has_xsave = (ecx >> 26) & 1;
+    int has_avx = (ecx >> 28) & 1;
+    if (has_xsave && has_avx) {
+        write_cr4(read_cr4() | CR4_OSXSAVE);
+        xsetbv(0, xgetbv(0) | XCR0_X87 | XCR0_SSE | XCR0_AVX);
+        simd_features |= SIMD_AVX;
+
+        if (max_leaf >= 7) {
+            cpuid(7, 0, 0, &ebx7, 0, 0);
+            if (ebx7 & (1 << 5)) simd_features |= SIMD_AVX2;
+        }
+    }
+}
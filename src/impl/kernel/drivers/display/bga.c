@@ -0,0 +1,91 @@
+#include "drivers/display/bga.h"
+#include "util/io.h"
+
+#define VBE_DISPI_IOPORT_INDEX 0x01CE
+#define VBE_DISPI_IOPORT_DATA  0x01CF
+
+#define VBE_DISPI_INDEX_ID          0x0
+#define VBE_DISPI_INDEX_XRES        0x1
+#define VBE_DISPI_INDEX_YRES        0x2
+#define VBE_DISPI_INDEX_BPP         0x3
+#define VBE_DISPI_INDEX_ENABLE      0x4
+#define VBE_DISPI_INDEX_VIRT_WIDTH  0x6
+#define VBE_DISPI_INDEX_VIRT_HEIGHT 0x7
+#define VBE_DISPI_INDEX_X_OFFSET    0x8
+#define VBE_DISPI_INDEX_Y_OFFSET    0x9
+#define VBE_DISPI_INDEX_VIDEO_MEMORY_64K 0xA
+
+#define VBE_DISPI_ID0 0xB0C0
+#define VBE_DISPI_ID5 0xB0C5
+
+#define VBE_DISPI_ENABLED     0x01
+#define VBE_DISPI_LFB_ENABLED 0x40
+#define VBE_DISPI_NOCLEARMEM  0x80
+
+// VGA input status #1: bit 3 is set during vertical retrace
+#define VGA_INPUT_STATUS_1 0x3DA
+#define VGA_VRETRACE 0x08
+#define VBLANK_SPIN_LIMIT 1000000
+
+static uint16_t bga_id = 0;
+
+static void bga_write(uint16_t index, uint16_t value) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    outw(VBE_DISPI_IOPORT_DATA, value);
+}
+
+static uint16_t bga_read(uint16_t index) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    return inw(VBE_DISPI_IOPORT_DATA);
+}
+
+int bga_init() {
+    uint16_t id = bga_read(VBE_DISPI_INDEX_ID);
+    bga_id = (id >= VBE_DISPI_ID0 && id <= VBE_DISPI_ID5) ? id : 0;
+    return bga_id != 0;
+}
+
+int bga_available() {
+    return bga_id != 0;
+}
+
+uint32_t bga_vram_size() {
+    // The memory size register only exists from ID5 on
+    if (bga_id < VBE_DISPI_ID5) return 0;
+    return (uint32_t)bga_read(VBE_DISPI_INDEX_VIDEO_MEMORY_64K) * 65536;
+}
+
+void bga_set_mode(uint32_t width, uint32_t height, uint32_t bpp) {
+    if (!bga_id) return;
+    bga_write(VBE_DISPI_INDEX_ENABLE, 0);
+    bga_write(VBE_DISPI_INDEX_XRES, width);
+    bga_write(VBE_DISPI_INDEX_YRES, height);
+    bga_write(VBE_DISPI_INDEX_BPP, bpp);
+    bga_write(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_ENABLED | VBE_DISPI_LFB_ENABLED | VBE_DISPI_NOCLEARMEM);
+}
+
+int bga_set_virtual(uint32_t virt_width, uint32_t virt_height) {
+    if (!bga_id) return 0;
+    bga_write(VBE_DISPI_INDEX_VIRT_WIDTH, virt_width);
+    bga_write(VBE_DISPI_INDEX_VIRT_HEIGHT, virt_height);
+    bga_write(VBE_DISPI_INDEX_X_OFFSET, 0);
+    bga_write(VBE_DISPI_INDEX_Y_OFFSET, 0);
+
+    // The adapter clamps to what fits in VRAM; read back to verify
+    return bga_read(VBE_DISPI_INDEX_VIRT_WIDTH) == virt_width &&
+           bga_read(VBE_DISPI_INDEX_VIRT_HEIGHT) >= virt_height;
+}
+
+void bga_set_y_offset(uint32_t y) {
+    if (!bga_id) return;
+    bga_write(VBE_DISPI_INDEX_Y_OFFSET, y);
+}
+
+// Wait for the start of the next vertical retrace. Bounded so that a
+// device without retrace emulation cannot hang the frame loop.
+void bga_wait_vblank() {
+    uint32_t spin = VBLANK_SPIN_LIMIT;
+    while ((inb(VGA_INPUT_STATUS_1) & VGA_VRETRACE) && spin--);
+    spin = VBLANK_SPIN_LIMIT;
+    while (!(inb(VGA_INPUT_STATUS_1) & VGA_VRETRACE) && spin--);
+}
@@ -0,0 +1,160 @@
+#include "drivers/display/blend.h"
+#include "cpu/simd.h"
+#include <immintrin.h>
+
+// x / 255 for x <= 255 * 255, exact with rounding: (t + (t >> 8)) >> 8, t = x + 128
+
+// --- Scalar: two channels per multiply (0x00RR00BB and 0x00AA00GG) ---
+
+static uint32_t div255_pairs(uint32_t x) {
+    uint32_t t = x + 0x00800080;
+    return ((t + ((t >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+}
+
+uint32_t blend_over(uint32_t dst, uint32_t src) {
+    uint32_t ia = 255 - (src >> 24);
+    if (ia == 0) return src;
+    uint32_t rb = div255_pairs((dst & 0x00FF00FF) * ia);
+    uint32_t ag = div255_pairs(((dst >> 8) & 0x00FF00FF) * ia);
+    return src + (rb | (ag << 8));
+}
+
+uint32_t blend_premultiply(uint32_t argb) {
+    uint32_t a = argb >> 24;
+    uint32_t rb = div255_pairs((argb & 0x00FF00FF) * a);
+    uint32_t g = div255_pairs(((argb >> 8) & 0xFF) * a);
+    return (a << 24) | rb | (g << 8);
+}
+
+static void fill32_scalar(uint32_t* dst, uint32_t src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) dst[i] = blend_over(dst[i], src);
+}
+
+static void span32_scalar(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t s = src[i];
+        if (s >= 0xFF000000) dst[i] = s;
+        else if (s >> 24) dst[i] = blend_over(dst[i], s);
+    }
+}
+
+// --- SSE2: 4 pixels per iteration, channels widened to 16 bits ---
+
+static inline __m128i div255_epu16(__m128i x) {
+    __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// d * ia / 255 for 4 pixels; ia holds 255 - alpha in both halves of each dword
+static inline __m128i scale4_sse2(__m128i d, __m128i ia) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(ia, ia));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(ia, ia));
+    return _mm_packus_epi16(div255_epu16(lo), div255_epu16(hi));
+}
+
+static void fill32_sse2(uint32_t* dst, uint32_t src, uint32_t count) {
+    uint32_t a = src >> 24;
+    if (a == 0) return;
+    __m128i s = _mm_set1_epi32((int)src);
+    if (a == 255) {
+        for (; count >= 4; count -= 4, dst += 4) _mm_storeu_si128((__m128i*)dst, s);
+        fill32_scalar(dst, src, count);
+        return;
+    }
+    __m128i ia = _mm_set1_epi16((short)(255 - a));
+    for (; count >= 4; count -= 4, dst += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)dst);
+        _mm_storeu_si128((__m128i*)dst, _mm_adds_epu8(s, scale4_sse2(d, ia)));
+    }
+    fill32_scalar(dst, src, count);
+}
+
+static void span32_sse2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i ones = _mm_set1_epi32(255);
+    for (; count >= 4; count -= 4, dst += 4, src += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)src);
+        __m128i sa = _mm_and_si128(s, alpha);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, alpha)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)dst, s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, _mm_setzero_si128())) == 0xFFFF) continue;
+        __m128i ia = _mm_sub_epi32(ones, _mm_srli_epi32(s, 24));
+        ia = _mm_or_si128(ia, _mm_slli_epi32(ia, 16));
+        __m128i d = _mm_loadu_si128((const __m128i*)dst);
+        _mm_storeu_si128((__m128i*)dst, _mm_adds_epu8(s, scale4_sse2(d, ia)));
+    }
+    span32_scalar(dst, src, count);
+}
+
+// --- AVX2: 8 pixels per iteration (unpacks stay within 128-bit lanes, so
+// the alpha broadcast lines up with the widened channels as in SSE2) ---
+
+__attribute__((target("avx2")))
+static inline __m256i div255_epu16_avx2(__m256i x) {
+    __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i scale8_avx2(__m256i d, __m256i ia) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(ia, ia));
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(ia, ia));
+    return _mm256_packus_epi16(div255_epu16_avx2(lo), div255_epu16_avx2(hi));
+}
+
+__attribute__((target("avx2")))
+static void fill32_avx2(uint32_t* dst, uint32_t src, uint32_t count) {
+    uint32_t a = src >> 24;
+    if (a == 0) return;
+    __m256i s = _mm256_set1_epi32((int)src);
+    if (a == 255) {
+        for (; count >= 8; count -= 8, dst += 8) _mm256_storeu_si256((__m256i*)dst, s);
+    } else {
+        __m256i ia = _mm256_set1_epi16((short)(255 - a));
+        for (; count >= 8; count -= 8, dst += 8) {
+            __m256i d = _mm256_loadu_si256((const __m256i*)dst);
+            _mm256_storeu_si256((__m256i*)dst, _mm256_adds_epu8(s, scale8_avx2(d, ia)));
+        }
+    }
+    _mm256_zeroupper();
+    fill32_scalar(dst, src, count);
+}
+
+__attribute__((target("avx2")))
+static void span32_avx2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i ones = _mm256_set1_epi32(255);
+    for (; count >= 8; count -= 8, dst += 8, src += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)src);
+        __m256i sa = _mm256_and_si256(s, alpha);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, alpha)) == -1) {
+            _mm256_storeu_si256((__m256i*)dst, s);
+            continue;
+        }
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, _mm256_setzero_si256())) == -1) continue;
+        __m256i ia = _mm256_sub_epi32(ones, _mm256_srli_epi32(s, 24));
+        ia = _mm256_or_si256(ia, _mm256_slli_epi32(ia, 16));
+        __m256i d = _mm256_loadu_si256((const __m256i*)dst);
+        _mm256_storeu_si256((__m256i*)dst, _mm256_adds_epu8(s, scale8_avx2(d, ia)));
+    }
+    _mm256_zeroupper();
+    span32_scalar(dst, src, count);
+}
+
+// Scalar until blend_init() runs (SSE must be enabled in CR4 first)
+void (*blend_fill32)(uint32_t* dst, uint32_t src, uint32_t count) = fill32_scalar;
+void (*blend_span32)(uint32_t* dst, const uint32_t* src, uint32_t count) = span32_scalar;
+
+void blend_init() {
+    if (simd_features & SIMD_AVX2) {
+        blend_fill32 = fill32_avx2;
+        blend_span32 = span32_avx2;
+    } else if (simd_features & SIMD_SSE2) {
+        blend_fill32 = fill32_sse2;
+        blend_span32 = span32_sse2;
+    }
+}
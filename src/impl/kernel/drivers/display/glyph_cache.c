@@ -0,0 +1,135 @@
+#include "drivers/display/glyph_cache.h"
+#include "drivers/display/font.h"
+#include "drivers/framebuffer.h"
+
+#define GLYPH_CACHE_SLOTS 256
+#define GLYPH_CACHE_BUCKETS 128 // power of two
+#define GLYPH_TILE_MAX_SIDE (8 * GLYPH_CACHE_MAX_SCALE)
+#define GLYPH_TILE_MAX_PIXELS (GLYPH_TILE_MAX_SIDE * GLYPH_TILE_MAX_SIDE)
+
+struct GlyphEntry {
+    uint32_t fg;
+    uint32_t bg;
+    uint8_t c;
+    uint8_t scale;    // 0 = slot unused
+    int16_t hash_next;
+    int16_t lru_prev; // towards most recently used
+    int16_t lru_next; // towards least recently used
+};
+
+// Tile arena: one fixed-size slot per entry, sized for the largest scale at 32 bpp
+static uint32_t tile_arena[GLYPH_CACHE_SLOTS][GLYPH_TILE_MAX_PIXELS] __attribute__((aligned(16)));
+static struct GlyphEntry entries[GLYPH_CACHE_SLOTS];
+static int16_t buckets[GLYPH_CACHE_BUCKETS];
+static int16_t lru_head = -1;
+static int16_t lru_tail = -1;
+static int cache_ready = 0;
+static struct GlyphCacheStats stats = {0};
+
+static uint32_t glyph_hash(char c, int scale, uint32_t fg, uint32_t bg) {
+    uint32_t h = (uint8_t)c * 0x9E3779B1u;
+    h ^= (uint32_t)scale * 0x85EBCA6Bu;
+    h ^= fg * 0xC2B2AE35u;
+    h ^= (bg ^ (bg >> 16)) * 0x27D4EB2Fu;
+    return (h ^ (h >> 15)) & (GLYPH_CACHE_BUCKETS - 1);
+}
+
+static void lru_unlink(int16_t i) {
+    if (entries[i].lru_prev >= 0) entries[entries[i].lru_prev].lru_next = entries[i].lru_next;
+    else lru_head = entries[i].lru_next;
+    if (entries[i].lru_next >= 0) entries[entries[i].lru_next].lru_prev = entries[i].lru_prev;
+    else lru_tail = entries[i].lru_prev;
+}
+
+static void lru_push_front(int16_t i) {
+    entries[i].lru_prev = -1;
+    entries[i].lru_next = lru_head;
+    if (lru_head >= 0) entries[lru_head].lru_prev = i;
+    lru_head = i;
+    if (lru_tail < 0) lru_tail = i;
+}
+
+static void cache_init(void) {
+    for (int i = 0; i < GLYPH_CACHE_BUCKETS; i++) buckets[i] = -1;
+    for (int16_t i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+        entries[i].scale = 0;
+        entries[i].hash_next = -1;
+        lru_push_front(i);
+    }
+    cache_ready = 1;
+}
+
+static void hash_remove(int16_t i) {
+    const struct GlyphEntry* e = &entries[i];
+    int16_t* link = &buckets[glyph_hash(e->c, e->scale, e->fg, e->bg)];
+    while (*link >= 0) {
+        if (*link == i) {
+            *link = e->hash_next;
+            return;
+        }
+        link = &entries[*link].hash_next;
+    }
+}
+
+static void render_tile(uint8_t* tile, char c, int scale, uint32_t fg, uint32_t bg) {
+    const struct PixelOps* ops = framebuffer_pixel_ops();
+    uint32_t bytes = framebuffer_pixel_format()->bytes;
+    uint32_t fg_native = framebuffer_pack_color(fg);
+    uint32_t bg_native = framebuffer_pack_color(bg);
+    const uint8_t* glyph = font8x8_basic[c - 32];
+    int side = 8 * scale;
+    for (int row = 0; row < 8; row++) {
+        uint8_t* dst = tile + row * scale * side * bytes;
+        uint8_t bits = glyph[row];
+        // Build the first scanline of this font row, replicate it scale-1 times
+        for (int col = 0; col < 8; col++) {
+            ops->fill(dst + col * scale * bytes, (bits & 0x80) ? fg_native : bg_native, scale);
+            bits <<= 1;
+        }
+        for (int dy = 1; dy < scale; dy++) {
+            ops->copy(dst + dy * side * bytes, dst, side);
+        }
+    }
+}
+
+const uint8_t* glyph_cache_get(char c, int scale, uint32_t fg, uint32_t bg) {
+    if ((unsigned char)c < 32 || (unsigned char)c > 127 || scale < 1 || scale > GLYPH_CACHE_MAX_SCALE || bg == 0) return 0;
+    if (!cache_ready) cache_init();
+
+    uint32_t b = glyph_hash(c, scale, fg, bg);
+    for (int16_t i = buckets[b]; i >= 0; i = entries[i].hash_next) {
+        struct GlyphEntry* e = &entries[i];
+        if (e->c == (uint8_t)c && e->scale == scale && e->fg == fg && e->bg == bg) {
+            stats.hits++;
+            if (lru_head != i) {
+                lru_unlink(i);
+                lru_push_front(i);
+            }
+            return (const uint8_t*)tile_arena[i];
+        }
+    }
+
+    // Miss: recycle the least recently used slot
+    stats.misses++;
+    int16_t i = lru_tail;
+    lru_unlink(i);
+    if (entries[i].scale != 0) {
+        hash_remove(i);
+        stats.evictions++;
+    }
+
+    entries[i].c = (uint8_t)c;
+    entries[i].scale = (uint8_t)scale;
+    entries[i].fg = fg;
+    entries[i].bg = bg;
+    entries[i].hash_next = buckets[b];
+    buckets[b] = i;
+    lru_push_front(i);
+
+    render_tile((uint8_t*)tile_arena[i], c, scale, fg, bg);
+    return (const uint8_t*)tile_arena[i];
+}
+
+struct GlyphCacheStats glyph_cache_get_stats() {
+    return stats;
+}
@@ -1,5 +1,6 @@
 #include <drivers/display/graphics.h>
 #include <drivers/pci.h>
+#include <drivers/display/bga.h>
 
 // Major GPU Vendors
 #define VENDOR_INTEL    0x8086
@@ -29,6 +30,12 @@ int graphics_init() {
         return 0; // No dedicated GPU found
     }
     
+    // QEMU/Bochs standard VGA: bring up the DISPI interface for mode
+    // setting and page flipping
+    if (dev.vendor_id == VENDOR_QEMU) {
+        bga_init();
+    }
+
     // We found a GPU!
     // In a real OS, this is where we would:
     // 1. Map the BAR0/BAR1 memory regions (MMIO).
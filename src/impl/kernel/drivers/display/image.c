@@ -0,0 +1,210 @@
+#include "drivers/display/image.h"
+#include "drivers/display/blend.h"
+#include "drivers/framebuffer.h"
+
+static uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+// --- QOI (https://qoiformat.org/qoi-specification.pdf) ---
+
+#define QOI_HEADER_SIZE 14
+#define QOI_PADDING 8
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xC0
+#define QOI_OP_RGB   0xFE
+#define QOI_OP_RGBA  0xFF
+
+static int qoi_open(struct ImageDecoder* dec) {
+    const uint8_t* d = dec->data;
+    if (dec->size < QOI_HEADER_SIZE + QOI_PADDING ||
+        d[0] != 'q' || d[1] != 'o' || d[2] != 'i' || d[3] != 'f') return 0;
+    dec->width = read_be32(d + 4);
+    dec->height = read_be32(d + 8);
+    if (d[12] != 3 && d[12] != 4) return 0;
+    dec->format = IMAGE_QOI;
+    dec->has_alpha = d[12] == 4;
+    dec->pos = QOI_HEADER_SIZE;
+    dec->px = 0xFF000000;
+    dec->run = 0;
+    for (int i = 0; i < 64; i++) dec->index[i] = 0;
+    return 1;
+}
+
+static uint32_t qoi_hash(uint32_t px) {
+    uint32_t a = px >> 24, r = (px >> 16) & 0xFF, g = (px >> 8) & 0xFF, b = px & 0xFF;
+    return (r * 3 + g * 5 + b * 7 + a * 11) & 63;
+}
+
+static int qoi_row(struct ImageDecoder* dec, uint32_t* row) {
+    const uint8_t* d = dec->data;
+    uint32_t px = dec->px;
+    uint32_t run = dec->run;
+    uint32_t pos = dec->pos;
+    // The longest chunk is 5 bytes; the stream always ends in 8 bytes of padding
+    uint32_t limit = dec->size - QOI_PADDING;
+
+    for (uint32_t x = 0; x < dec->width; x++) {
+        if (run) {
+            run--;
+            row[x] = px;
+            continue;
+        }
+        if (pos >= limit) return 0;
+        uint8_t b1 = d[pos++];
+        if (b1 == QOI_OP_RGB) {
+            px = (px & 0xFF000000) | ((uint32_t)d[pos] << 16) | (d[pos + 1] << 8) | d[pos + 2];
+            pos += 3;
+        } else if (b1 == QOI_OP_RGBA) {
+            px = ((uint32_t)d[pos + 3] << 24) | ((uint32_t)d[pos] << 16) | (d[pos + 1] << 8) | d[pos + 2];
+            pos += 4;
+        } else {
+            switch (b1 & 0xC0) {
+            case QOI_OP_INDEX:
+                px = dec->index[b1];
+                break;
+            case QOI_OP_DIFF: {
+                uint32_t r = ((px >> 16) + ((b1 >> 4) & 3) - 2) & 0xFF;
+                uint32_t g = ((px >> 8) + ((b1 >> 2) & 3) - 2) & 0xFF;
+                uint32_t b = (px + (b1 & 3) - 2) & 0xFF;
+                px = (px & 0xFF000000) | (r << 16) | (g << 8) | b;
+                break;
+            }
+            case QOI_OP_LUMA: {
+                uint8_t b2 = d[pos++];
+                int32_t vg = (b1 & 0x3F) - 32;
+                uint32_t r = ((px >> 16) + vg - 8 + ((b2 >> 4) & 0x0F)) & 0xFF;
+                uint32_t g = ((px >> 8) + vg) & 0xFF;
+                uint32_t b = (px + vg - 8 + (b2 & 0x0F)) & 0xFF;
+                px = (px & 0xFF000000) | (r << 16) | (g << 8) | b;
+                break;
+            }
+            case QOI_OP_RUN:
+                run = b1 & 0x3F;
+                break;
+            }
+        }
+        dec->index[qoi_hash(px)] = px;
+        row[x] = px;
+    }
+
+    dec->px = px;
+    dec->run = run;
+    dec->pos = pos;
+    return 1;
+}
+
+// --- BMP: BITMAPINFOHEADER or later, BI_RGB 24/32 bpp or BI_BITFIELDS with
+// the standard 8:8:8(:8) masks ---
+
+#define BMP_FILE_HEADER_SIZE 14
+#define BMP_BI_RGB 0
+#define BMP_BI_BITFIELDS 3
+
+static int bmp_open(struct ImageDecoder* dec) {
+    const uint8_t* d = dec->data;
+    if (dec->size < BMP_FILE_HEADER_SIZE + 40 || d[0] != 'B' || d[1] != 'M') return 0;
+    uint32_t offset = read_le32(d + 10);
+    uint32_t header = read_le32(d + 14);
+    int32_t w = (int32_t)read_le32(d + 18);
+    int32_t h = (int32_t)read_le32(d + 22);
+    uint16_t bpp = read_le16(d + 28);
+    uint32_t compression = read_le32(d + 30);
+    if (header < 40 || w <= 0 || h == 0 || (bpp != 24 && bpp != 32)) return 0;
+
+    dec->has_alpha = 0;
+    if (compression == BMP_BI_BITFIELDS) {
+        // Masks follow a 40-byte header, or are part of a V4/V5 header
+        if (bpp != 32 || dec->size < BMP_FILE_HEADER_SIZE + 40 + 12) return 0;
+        const uint8_t* m = d + BMP_FILE_HEADER_SIZE + 40;
+        if (read_le32(m) != 0x00FF0000 || read_le32(m + 4) != 0x0000FF00 ||
+            read_le32(m + 8) != 0x000000FF) return 0;
+        dec->has_alpha = header >= 56 && read_le32(m + 12) == 0xFF000000;
+    } else if (compression != BMP_BI_RGB) {
+        return 0;
+    }
+
+    dec->format = IMAGE_BMP;
+    dec->width = (uint32_t)w;
+    dec->height = h < 0 ? (uint32_t)-h : (uint32_t)h;
+    dec->bmp_bpp = bpp;
+    dec->bmp_bottom_up = h > 0;
+    dec->bmp_stride = ((dec->width * bpp + 31) / 32) * 4;
+    dec->pos = offset;
+    if (offset > dec->size || (uint64_t)dec->bmp_stride * dec->height > dec->size - offset) return 0;
+    return 1;
+}
+
+static const uint32_t* bmp_row(struct ImageDecoder* dec, uint32_t* row) {
+    uint32_t r = dec->bmp_bottom_up ? dec->height - 1 - dec->row : dec->row;
+    const uint8_t* src = dec->data + dec->pos + r * dec->bmp_stride;
+    if (dec->bmp_bpp == 32) {
+        // Rows already are 0xAARRGGBB in memory: hand them out in place when
+        // aligned (the pixel offset is usually 54, 66 or 138, so often not)
+        if (((uint64_t)src & 3) == 0) return (const uint32_t*)src;
+        for (uint32_t x = 0; x < dec->width; x++, src += 4) {
+            row[x] = ((uint32_t)src[3] << 24) | ((uint32_t)src[2] << 16) | (src[1] << 8) | src[0];
+        }
+        return row;
+    }
+    for (uint32_t x = 0; x < dec->width; x++, src += 3) {
+        row[x] = 0xFF000000 | ((uint32_t)src[2] << 16) | (src[1] << 8) | src[0];
+    }
+    return row;
+}
+
+// --- Public API ---
+
+int image_open(struct ImageDecoder* dec, const void* data, uint32_t size) {
+    dec->data = (const uint8_t*)data;
+    dec->size = size;
+    dec->row = 0;
+    if (!qoi_open(dec) && !bmp_open(dec)) return 0;
+    return dec->width > 0 && dec->width <= IMAGE_MAX_WIDTH && dec->height > 0;
+}
+
+const uint32_t* image_next_row(struct ImageDecoder* dec, uint32_t* row) {
+    if (dec->row >= dec->height) return 0;
+    const uint32_t* out = row;
+    if (dec->format == IMAGE_QOI) {
+        if (!qoi_row(dec, row)) return 0;
+    } else {
+        out = bmp_row(dec, row);
+    }
+    dec->row++;
+    return out;
+}
+
+static uint32_t draw_row_buf[IMAGE_MAX_WIDTH];
+
+int image_draw(const void* data, uint32_t size, int32_t x, int32_t y) {
+    struct ImageDecoder dec;
+    if (!image_open(&dec, data, size)) return 0;
+    if (framebuffer_clip_rejects(x, y, (int32_t)dec.width, (int32_t)dec.height)) return 1;
+
+    // Rows above the clip are still decoded (QOI is a stream); stop below it
+    struct FbRect clip = framebuffer_get_clip();
+    int32_t y_end = (int32_t)(clip.y + clip.h);
+    for (int32_t row = y; row < y + (int32_t)dec.height && row < y_end; row++) {
+        const uint32_t* px = image_next_row(&dec, draw_row_buf);
+        if (!px) return 0;
+        if (row < (int32_t)clip.y) continue;
+        if (dec.has_alpha) {
+            for (uint32_t i = 0; i < dec.width; i++) draw_row_buf[i] = blend_premultiply(px[i]);
+            framebuffer_blend_bitmap(draw_row_buf, x, row, dec.width, 1, dec.width);
+        } else {
+            framebuffer_draw_row(x, row, px, dec.width);
+        }
+    }
+    return 1;
+}
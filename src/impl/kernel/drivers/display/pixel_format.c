@@ -0,0 +1,219 @@
+#include "drivers/display/pixel_format.h"
+#include "drivers/display/span.h"
+
+const struct PixelFormat pixel_format_xrgb8888 = { 32, 4, 16, 8, 8, 8, 0, 8 };
+
+int pixel_format_from_tag(struct PixelFormat* fmt, uint8_t bpp,
+                          uint8_t red_pos, uint8_t red_size,
+                          uint8_t green_pos, uint8_t green_size,
+                          uint8_t blue_pos, uint8_t blue_size) {
+    if (bpp != 16 && bpp != 24 && bpp != 32) return 0;
+    if (red_size == 0 || red_size > 8 || green_size == 0 || green_size > 8 ||
+        blue_size == 0 || blue_size > 8) return 0;
+    if (red_pos + red_size > bpp || green_pos + green_size > bpp || blue_pos + blue_size > bpp) return 0;
+
+    fmt->bpp = bpp;
+    fmt->bytes = bpp / 8;
+    fmt->red_pos = red_pos;
+    fmt->red_size = red_size;
+    fmt->green_pos = green_pos;
+    fmt->green_size = green_size;
+    fmt->blue_pos = blue_pos;
+    fmt->blue_size = blue_size;
+    return 1;
+}
+
+uint32_t pixel_pack(const struct PixelFormat* fmt, uint32_t argb) {
+    uint32_t r = (argb >> 16) & 0xFF;
+    uint32_t g = (argb >> 8) & 0xFF;
+    uint32_t b = argb & 0xFF;
+    return ((r >> (8 - fmt->red_size)) << fmt->red_pos) |
+           ((g >> (8 - fmt->green_size)) << fmt->green_pos) |
+           ((b >> (8 - fmt->blue_size)) << fmt->blue_pos);
+}
+
+// Scale an n-bit channel back to 8 bits by bit replication
+static uint32_t channel_expand(uint32_t v, uint8_t size) {
+    v <<= 8 - size;
+    return v | (v >> size);
+}
+
+uint32_t pixel_unpack(const struct PixelFormat* fmt, uint32_t native) {
+    uint32_t r = (native >> fmt->red_pos) & ((1u << fmt->red_size) - 1);
+    uint32_t g = (native >> fmt->green_pos) & ((1u << fmt->green_size) - 1);
+    uint32_t b = (native >> fmt->blue_pos) & ((1u << fmt->blue_size) - 1);
+    return 0xFF000000 | (channel_expand(r, fmt->red_size) << 16) |
+           (channel_expand(g, fmt->green_size) << 8) | channel_expand(b, fmt->blue_size);
+}
+
+// --- Non-temporal byte streaming (16/24 bpp rows need not be dword aligned) ---
+
+static void stream_bytes(uint8_t* dst, const uint8_t* src, uint32_t n) {
+    while (n > 0 && ((uintptr_t)dst & 3)) {
+        *dst++ = *src++;
+        n--;
+    }
+    // Back buffer rows and VRAM rows share the same x offset, so the source
+    // is normally aligned too; otherwise fall back to dword loads.
+    if (((uintptr_t)src & 3) == 0) {
+        span_stream32((uint32_t*)dst, (const uint32_t*)src, n / 4);
+    } else {
+        for (uint32_t i = 0; i < n / 4; i++) {
+            ((volatile uint32_t*)dst)[i] = (uint32_t)src[i * 4] | ((uint32_t)src[i * 4 + 1] << 8) |
+                                           ((uint32_t)src[i * 4 + 2] << 16) | ((uint32_t)src[i * 4 + 3] << 24);
+        }
+    }
+    dst += n & ~3u;
+    src += n & ~3u;
+    for (uint32_t i = 0; i < (n & 3); i++) dst[i] = src[i];
+}
+
+// --- 32 bpp: straight onto the SIMD span kernels ---
+
+static void fill_32(uint8_t* dst, uint32_t color, uint32_t count) {
+    span_fill32((uint32_t*)dst, color, count);
+}
+
+static void copy_32(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    span_copy32((uint32_t*)dst, (const uint32_t*)src, count);
+}
+
+static void stream_32(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    span_stream32((uint32_t*)dst, (const uint32_t*)src, count);
+}
+
+static void glyph8_32(uint8_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) {
+    span_glyph8((uint32_t*)dst, bits, fg, bg);
+}
+
+static void glyph8_fg_32(uint8_t* dst, uint8_t bits, uint32_t fg) {
+    span_glyph8_fg((uint32_t*)dst, bits, fg);
+}
+
+// --- 16 bpp: pixel pairs go through the 32-bit kernels ---
+
+static void fill_16(uint8_t* dst, uint32_t color, uint32_t count) {
+    uint16_t* p = (uint16_t*)dst;
+    if (count > 0 && ((uintptr_t)p & 2)) {
+        *p++ = (uint16_t)color;
+        count--;
+    }
+    span_fill32((uint32_t*)p, (color & 0xFFFF) * 0x00010001u, count / 2);
+    if (count & 1) p[count - 1] = (uint16_t)color;
+}
+
+static void copy_16(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    uint16_t* d = (uint16_t*)dst;
+    const uint16_t* s = (const uint16_t*)src;
+    if (((uintptr_t)d & 2) != ((uintptr_t)s & 2)) {
+        for (uint32_t i = 0; i < count; i++) d[i] = s[i];
+        return;
+    }
+    if (count > 0 && ((uintptr_t)d & 2)) {
+        *d++ = *s++;
+        count--;
+    }
+    span_copy32((uint32_t*)d, (const uint32_t*)s, count / 2);
+    if (count & 1) d[count - 1] = s[count - 1];
+}
+
+static void stream_16(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    stream_bytes(dst, src, count * 2);
+}
+
+static void glyph8_16(uint8_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) {
+    uint16_t* p = (uint16_t*)dst;
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint16_t)((bits & 0x80) ? fg : bg);
+        bits <<= 1;
+    }
+}
+
+static void glyph8_fg_16(uint8_t* dst, uint8_t bits, uint32_t fg) {
+    uint16_t* p = (uint16_t*)dst;
+    for (int i = 0; i < 8; i++) {
+        if (bits & 0x80) p[i] = (uint16_t)fg;
+        bits <<= 1;
+    }
+}
+
+// --- 24 bpp: packed byte triples ---
+
+static void fill_24(uint8_t* dst, uint32_t color, uint32_t count) {
+    uint8_t c0 = color, c1 = color >> 8, c2 = color >> 16;
+    // Four pixels make three dwords; prime one group and replicate it
+    if (count >= 8 && ((uintptr_t)dst & 3) == 0) {
+        uint32_t group[3];
+        group[0] = c0 | (c1 << 8) | (c2 << 16) | ((uint32_t)c0 << 24);
+        group[1] = c1 | (c2 << 8) | (c0 << 16) | ((uint32_t)c1 << 24);
+        group[2] = c2 | (c0 << 8) | (c1 << 16) | ((uint32_t)c2 << 24);
+        uint32_t* d = (uint32_t*)dst;
+        uint32_t groups = count / 4;
+        for (uint32_t i = 0; i < groups; i++) {
+            d[0] = group[0];
+            d[1] = group[1];
+            d[2] = group[2];
+            d += 3;
+        }
+        dst = (uint8_t*)d;
+        count &= 3;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        dst[0] = c0;
+        dst[1] = c1;
+        dst[2] = c2;
+        dst += 3;
+    }
+}
+
+static void copy_24(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    uint32_t n = count * 3;
+    if ((((uintptr_t)dst | (uintptr_t)src) & 3) == 0) {
+        span_copy32((uint32_t*)dst, (const uint32_t*)src, n / 4);
+        dst += n & ~3u;
+        src += n & ~3u;
+        n &= 3;
+    }
+    for (uint32_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+static void stream_24(uint8_t* dst, const uint8_t* src, uint32_t count) {
+    stream_bytes(dst, src, count * 3);
+}
+
+static void glyph8_24(uint8_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) {
+    for (int i = 0; i < 8; i++) {
+        uint32_t c = (bits & 0x80) ? fg : bg;
+        dst[0] = c;
+        dst[1] = c >> 8;
+        dst[2] = c >> 16;
+        dst += 3;
+        bits <<= 1;
+    }
+}
+
+static void glyph8_fg_24(uint8_t* dst, uint8_t bits, uint32_t fg) {
+    for (int i = 0; i < 8; i++) {
+        if (bits & 0x80) {
+            dst[0] = fg;
+            dst[1] = fg >> 8;
+            dst[2] = fg >> 16;
+        }
+        dst += 3;
+        bits <<= 1;
+    }
+}
+
+#define PIXEL_OPS(bits) { #bits " bpp", fill_##bits, copy_##bits, stream_##bits, glyph8_##bits, glyph8_fg_##bits }
+
+static const struct PixelOps ops_32 = PIXEL_OPS(32);
+static const struct PixelOps ops_24 = PIXEL_OPS(24);
+static const struct PixelOps ops_16 = PIXEL_OPS(16);
+
+const struct PixelOps* pixel_format_ops(const struct PixelFormat* fmt) {
+    switch (fmt->bytes) {
+        case 2: return &ops_16;
+        case 3: return &ops_24;
+        default: return &ops_32;
+    }
+}
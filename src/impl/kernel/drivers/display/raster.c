@@ -0,0 +1,335 @@
+#include "drivers/display/raster.h"
+#include "drivers/display/blend.h"
+#include "drivers/framebuffer.h"
+
+// Sampled shapes are evaluated on horizontal sample lines and return the
+// covered [a, b) intervals in 1/SUB pixel units.
+#define SUB 16
+#define SUB_SHIFT 4
+#define SUB_ROWS 4                    // AA sample lines per pixel row
+#define FULL_COVER (SUB * SUB_ROWS)   // coverage of a fully covered pixel
+#define RASTER_MAX_WIDTH 4096
+
+// --- Span output, shared by every shape ---
+
+static const struct PixelOps* ops;
+static uint32_t fill_color;                   // native, solid spans
+static uint32_t cover_color[FULL_COVER + 1];  // premultiplied, by coverage
+static int32_t clip_x1, clip_y1, clip_x2, clip_y2;
+static int32_t box_x1, box_y1, box_x2, box_y2; // bounds of what was drawn
+
+// Alpha of color is ignored, as in framebuffer_draw_rect()
+static int shape_begin(uint32_t color, int flags) {
+    if (fb.base_address == 0) return 0;
+    struct FbRect c = framebuffer_get_clip();
+    if (c.w == 0 || c.h == 0) return 0;
+    clip_x1 = c.x;
+    clip_y1 = c.y;
+    clip_x2 = c.x + c.w < RASTER_MAX_WIDTH ? c.x + c.w : RASTER_MAX_WIDTH;
+    clip_y2 = c.y + c.h;
+    if (clip_x1 >= clip_x2) return 0;
+
+    ops = framebuffer_pixel_ops();
+    fill_color = framebuffer_pack_color(color);
+    if (flags & RASTER_AA) {
+        for (uint32_t i = 0; i <= FULL_COVER; i++) {
+            uint32_t a = (255 * i + FULL_COVER / 2) / FULL_COVER;
+            cover_color[i] = blend_premultiply((a << 24) | (color & 0x00FFFFFF));
+        }
+    }
+    box_x1 = box_y1 = INT32_MAX;
+    box_x2 = box_y2 = INT32_MIN;
+    return 1;
+}
+
+static void box_add(int32_t x0, int32_t x1, int32_t y) {
+    if (x0 < box_x1) box_x1 = x0;
+    if (x1 > box_x2) box_x2 = x1;
+    if (y < box_y1) box_y1 = y;
+    if (y >= box_y2) box_y2 = y + 1;
+}
+
+static void shape_end(void) {
+    if (box_x1 < box_x2) framebuffer_mark_dirty(box_x1, box_y1, box_x2 - box_x1, box_y2 - box_y1);
+}
+
+// The one fill routine: solid span [x0, x1) on row y, clipped
+static void span(int32_t x0, int32_t x1, int32_t y) {
+    if (y < clip_y1 || y >= clip_y2) return;
+    if (x0 < clip_x1) x0 = clip_x1;
+    if (x1 > clip_x2) x1 = clip_x2;
+    if (x0 >= x1) return;
+    ops->fill(framebuffer_back_pixel(x0, y), fill_color, x1 - x0);
+    box_add(x0, x1, y);
+}
+
+// --- Coverage accumulation (AA) for one pixel row ---
+
+static uint8_t cover[RASTER_MAX_WIDTH];
+static int32_t cover_min, cover_max; // touched pixels, inclusive
+
+static void cover_add(int32_t a, int32_t b) {
+    if (a < clip_x1 * SUB) a = clip_x1 * SUB;
+    if (b > clip_x2 * SUB) b = clip_x2 * SUB;
+    if (a >= b) return;
+    int32_t pa = a >> SUB_SHIFT, pb = (b - 1) >> SUB_SHIFT;
+    if (pa == pb) {
+        cover[pa] += b - a;
+    } else {
+        cover[pa] += SUB - (a & (SUB - 1));
+        for (int32_t p = pa + 1; p < pb; p++) cover[p] += SUB;
+        cover[pb] += b - pb * SUB;
+    }
+    if (pa < cover_min) cover_min = pa;
+    if (pb > cover_max) cover_max = pb;
+}
+
+// Fully covered runs become solid spans, edge pixels are blended
+static void cover_flush(int32_t y) {
+    int32_t p = cover_min;
+    while (p <= cover_max) {
+        uint32_t c = cover[p];
+        if (c >= FULL_COVER) {
+            int32_t q = p;
+            while (q <= cover_max && cover[q] >= FULL_COVER) cover[q++] = 0;
+            span(p, q, y);
+            p = q;
+            continue;
+        }
+        if (c) {
+            framebuffer_blend_native(framebuffer_back_pixel(p, y), cover_color[c], 1);
+            box_add(p, p + 1, y);
+            cover[p] = 0;
+        }
+        p++;
+    }
+}
+
+// --- Sampled shapes ---
+
+#define SHAPE_CIRCLE     1
+#define SHAPE_ROUND_RECT 2
+#define SHAPE_POLYGON    3
+
+struct Shape {
+    int kind;
+    int32_t x, y, w, h, radius; // round rect (SUB units)
+    int32_t cx, cy, r, inner;   // circle / ring (SUB units, inner 0 = disc)
+    const int32_t* pts;         // polygon (SUB units)
+    uint32_t n;
+};
+
+static int32_t ivals[RASTER_MAX_POINTS + 4]; // interval end points, in pairs
+
+static uint32_t isqrt(uint64_t v) {
+    uint64_t r = 0, bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// Intervals covered on the sample line sy; returns the number of end points
+static uint32_t shape_sample(const struct Shape* s, int32_t sy) {
+    switch (s->kind) {
+    case SHAPE_CIRCLE: {
+        int32_t dy = sy - s->cy;
+        if (dy <= -s->r || dy >= s->r) return 0;
+        int32_t ho = isqrt((int64_t)s->r * s->r - (int64_t)dy * dy);
+        if (s->inner > 0 && dy > -s->inner && dy < s->inner) {
+            int32_t hi = isqrt((int64_t)s->inner * s->inner - (int64_t)dy * dy);
+            ivals[0] = s->cx - ho; ivals[1] = s->cx - hi;
+            ivals[2] = s->cx + hi; ivals[3] = s->cx + ho;
+            return 4;
+        }
+        ivals[0] = s->cx - ho;
+        ivals[1] = s->cx + ho;
+        return 2;
+    }
+    case SHAPE_ROUND_RECT: {
+        if (sy < s->y || sy >= s->y + s->h) return 0;
+        int32_t dy = 0;
+        if (sy < s->y + s->radius) dy = s->y + s->radius - sy;
+        else if (sy >= s->y + s->h - s->radius) dy = sy - (s->y + s->h - s->radius);
+        int32_t inset = dy ? s->radius - (int32_t)isqrt((int64_t)s->radius * s->radius - (int64_t)dy * dy) : 0;
+        ivals[0] = s->x + inset;
+        ivals[1] = s->x + s->w - inset;
+        return 2;
+    }
+    case SHAPE_POLYGON: {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < s->n; i++) {
+            uint32_t j = i + 1 == s->n ? 0 : i + 1;
+            int32_t x0 = s->pts[2 * i], y0 = s->pts[2 * i + 1];
+            int32_t x1 = s->pts[2 * j], y1 = s->pts[2 * j + 1];
+            if (!((y0 <= sy && sy < y1) || (y1 <= sy && sy < y0))) continue;
+            int32_t x = x0 + (int32_t)((int64_t)(sy - y0) * (x1 - x0) / (y1 - y0));
+            // Insertion sort by x
+            uint32_t k = count++;
+            while (k > 0 && ivals[k - 1] > x) {
+                ivals[k] = ivals[k - 1];
+                k--;
+            }
+            ivals[k] = x;
+        }
+        return count & ~1u;
+    }
+    }
+    return 0;
+}
+
+// Rasterize pixel rows [row0, row1) of a sampled shape
+static void shape_fill(const struct Shape* s, int32_t row0, int32_t row1, int flags) {
+    if (row0 < clip_y1) row0 = clip_y1;
+    if (row1 > clip_y2) row1 = clip_y2;
+    for (int32_t y = row0; y < row1; y++) {
+        if (!(flags & RASTER_AA)) {
+            // Pixels whose centres lie inside the shape
+            uint32_t n = shape_sample(s, y * SUB + SUB / 2);
+            for (uint32_t i = 0; i < n; i += 2) {
+                span((ivals[i] + SUB / 2 - 1) >> SUB_SHIFT, (ivals[i + 1] + SUB / 2 - 1) >> SUB_SHIFT, y);
+            }
+            continue;
+        }
+        cover_min = INT32_MAX;
+        cover_max = INT32_MIN;
+        for (int32_t sub = 0; sub < SUB_ROWS; sub++) {
+            uint32_t n = shape_sample(s, y * SUB + SUB / (2 * SUB_ROWS) + sub * (SUB / SUB_ROWS));
+            for (uint32_t i = 0; i < n; i += 2) cover_add(ivals[i], ivals[i + 1]);
+        }
+        if (cover_min <= cover_max) cover_flush(y);
+    }
+}
+
+static int32_t poly_pts[2 * RASTER_MAX_POINTS];
+
+static void polygon_fill(const int32_t* pts, uint32_t n, int flags) {
+    int32_t ymin = INT32_MAX, ymax = INT32_MIN;
+    for (uint32_t i = 0; i < n; i++) {
+        if (pts[2 * i + 1] < ymin) ymin = pts[2 * i + 1];
+        if (pts[2 * i + 1] > ymax) ymax = pts[2 * i + 1];
+    }
+    struct Shape s = {0};
+    s.kind = SHAPE_POLYGON;
+    s.pts = pts;
+    s.n = n;
+    shape_fill(&s, ymin >> SUB_SHIFT, (ymax + SUB - 1) >> SUB_SHIFT, flags);
+}
+
+// --- Public API ---
+
+void raster_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color, int flags) {
+    if (!shape_begin(color, flags)) return;
+
+    if (flags & RASTER_AA) {
+        // Quad one pixel wide, extended half a pixel past both end points
+        int32_t ax = x0 * SUB + SUB / 2, ay = y0 * SUB + SUB / 2;
+        int32_t bx = x1 * SUB + SUB / 2, by = y1 * SUB + SUB / 2;
+        int32_t dx = bx - ax, dy = by - ay;
+        int32_t len = isqrt((int64_t)dx * dx + (int64_t)dy * dy);
+        int32_t ex = len ? dx * (SUB / 2) / len : SUB / 2;
+        int32_t ey = len ? dy * (SUB / 2) / len : 0;
+        int32_t quad[8] = {
+            ax - ex - ey, ay - ey + ex,
+            bx + ex - ey, by + ey + ex,
+            bx + ex + ey, by + ey - ex,
+            ax - ex + ey, ay - ey - ex,
+        };
+        polygon_fill(quad, 4, flags);
+        shape_end();
+        return;
+    }
+
+    // Bresenham; consecutive pixels on one row are emitted as a single span
+    int32_t dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int32_t dy = y1 > y0 ? y0 - y1 : y1 - y0; // -|dy|
+    int32_t sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    int32_t run_x = x0;
+    while (x0 != x1 || y0 != y1) {
+        int32_t e2 = 2 * err;
+        int32_t nx = x0, ny = y0;
+        if (e2 >= dy) { err += dy; nx += sx; }
+        if (e2 <= dx) { err += dx; ny += sy; }
+        if (ny != y0) {
+            span(run_x < x0 ? run_x : x0, (run_x > x0 ? run_x : x0) + 1, y0);
+            run_x = nx;
+        }
+        x0 = nx;
+        y0 = ny;
+    }
+    span(run_x < x0 ? run_x : x0, (run_x > x0 ? run_x : x0) + 1, y0);
+    shape_end();
+}
+
+void raster_circle(int32_t cx, int32_t cy, int32_t r, int32_t stroke, uint32_t color, int flags) {
+    if (r < 0 || stroke < 0 || !shape_begin(color, flags)) return;
+    if (stroke > r) stroke = 0;
+
+    if (!(flags & RASTER_AA) && stroke <= 1) {
+        // Midpoint circle: four row spans (disc) or eight pixels (outline) per step
+        int32_t x = r, y = 0, err = 1 - r;
+        while (x >= y) {
+            if (stroke == 0) {
+                span(cx - x, cx + x + 1, cy + y);
+                span(cx - x, cx + x + 1, cy - y);
+                span(cx - y, cx + y + 1, cy + x);
+                span(cx - y, cx + y + 1, cy - x);
+            } else {
+                span(cx - x, cx - x + 1, cy + y); span(cx + x, cx + x + 1, cy + y);
+                span(cx - x, cx - x + 1, cy - y); span(cx + x, cx + x + 1, cy - y);
+                span(cx - y, cx - y + 1, cy + x); span(cx + y, cx + y + 1, cy + x);
+                span(cx - y, cx - y + 1, cy - x); span(cx + y, cx + y + 1, cy - x);
+            }
+            y++;
+            if (err < 0) {
+                err += 2 * y + 1;
+            } else {
+                x--;
+                err += 2 * (y - x) + 1;
+            }
+        }
+        shape_end();
+        return;
+    }
+
+    struct Shape s = {0};
+    s.kind = SHAPE_CIRCLE;
+    s.cx = cx * SUB + SUB / 2;
+    s.cy = cy * SUB + SUB / 2;
+    s.r = r * SUB + SUB / 2;
+    s.inner = stroke ? s.r - stroke * SUB : 0;
+    shape_fill(&s, cy - r, cy + r + 1, flags);
+    shape_end();
+}
+
+void raster_round_rect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color, int flags) {
+    if (w <= 0 || h <= 0 || !shape_begin(color, flags)) return;
+    if (radius > w / 2) radius = w / 2;
+    if (radius > h / 2) radius = h / 2;
+    if (radius < 0) radius = 0;
+
+    struct Shape s = {0};
+    s.kind = SHAPE_ROUND_RECT;
+    s.x = x * SUB;
+    s.y = y * SUB;
+    s.w = w * SUB;
+    s.h = h * SUB;
+    s.radius = radius * SUB;
+    shape_fill(&s, y, y + h, flags);
+    shape_end();
+}
+
+void raster_polygon(const int32_t* xy, uint32_t n, uint32_t color, int flags) {
+    if (n < 3 || n > RASTER_MAX_POINTS || !shape_begin(color, flags)) return;
+    for (uint32_t i = 0; i < 2 * n; i++) poly_pts[i] = xy[i] * SUB;
+    polygon_fill(poly_pts, n, flags);
+    shape_end();
+}
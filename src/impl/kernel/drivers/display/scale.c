@@ -0,0 +1,212 @@
+#include "drivers/display/scale.h"
+#include "drivers/display/span.h"
+#include "drivers/framebuffer.h"
+#include "cpu/simd.h"
+#include <immintrin.h>
+
+// Column plan: left source column of each destination pixel and the weight
+// (0..256) of its right neighbour, pre-splatted for SSE2 as 16-bit lanes
+// {4 x (256 - w), 4 x w} to match two unpacked pixels.
+static uint32_t col_x[SCALE_MAX_WIDTH];
+static uint16_t col_weight[SCALE_MAX_WIDTH][8] __attribute__((aligned(16)));
+static uint32_t plan_src_w = 0;
+static uint32_t plan_dst_w = 0;
+static int plan_filter = -1;
+
+// Horizontally resampled source rows, kept for the next destination row
+// (upscaling reuses each source row several times)
+static uint32_t row_mem[2][SCALE_MAX_WIDTH] __attribute__((aligned(16)));
+static uint32_t* hrow[2] = { row_mem[0], row_mem[1] };
+static uint32_t hrow_src[2];
+#define ROW_NONE 0xFFFFFFFF
+
+static uint32_t out_row[SCALE_MAX_WIDTH] __attribute__((aligned(16)));
+
+// Source position of destination pixel i (pixel centres aligned): index of
+// the first tap and the 0..256 weight of the second
+static void map_axis(uint32_t i, uint32_t src_n, uint32_t dst_n, int filter,
+                     uint32_t* pos, uint32_t* frac) {
+    if (filter == SCALE_NEAREST || src_n < 2) {
+        *pos = (uint32_t)(((2ull * i + 1) * src_n) / (2ull * dst_n));
+        *frac = 0;
+        return;
+    }
+    int64_t f = (int64_t)(((2ull * i + 1) * src_n * 256) / (2ull * dst_n)) - 128;
+    if (f < 0) f = 0;
+    uint32_t p = (uint32_t)(f >> 8);
+    uint32_t w = (uint32_t)(f & 255);
+    if (p >= src_n - 1) {
+        p = src_n - 2;
+        w = 256;
+    }
+    *pos = p;
+    *frac = w;
+}
+
+static void build_plan(uint32_t src_w, uint32_t dst_w, int filter) {
+    if (src_w == plan_src_w && dst_w == plan_dst_w && filter == plan_filter) return;
+    for (uint32_t i = 0; i < dst_w; i++) {
+        uint32_t w;
+        map_axis(i, src_w, dst_w, filter, &col_x[i], &w);
+        for (int k = 0; k < 4; k++) {
+            col_weight[i][k] = (uint16_t)(256 - w);
+            col_weight[i][k + 4] = (uint16_t)w;
+        }
+    }
+    plan_src_w = src_w;
+    plan_dst_w = dst_w;
+    plan_filter = filter;
+}
+
+// --- Scalar: two channels per multiply (0x00RR00BB and 0x00AA00GG) ---
+
+static uint32_t lerp_pixel(uint32_t a, uint32_t b, uint32_t w) {
+    uint32_t iw = 256 - w;
+    uint32_t rb = (((a & 0x00FF00FF) * iw + (b & 0x00FF00FF) * w) >> 8) & 0x00FF00FF;
+    uint32_t ag = (((a >> 8) & 0x00FF00FF) * iw + ((b >> 8) & 0x00FF00FF) * w) & 0xFF00FF00;
+    return rb | ag;
+}
+
+static void hrow_nearest(const uint32_t* s, uint32_t* out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) out[i] = s[col_x[i]];
+}
+
+static void hrow_bilinear_scalar(const uint32_t* s, uint32_t* out, uint32_t i, uint32_t n) {
+    for (; i < n; i++) out[i] = lerp_pixel(s[col_x[i]], s[col_x[i] + 1], col_weight[i][4]);
+}
+
+static void vrow_scalar(const uint32_t* a, const uint32_t* b, uint32_t* out, uint32_t i, uint32_t n, uint32_t w) {
+    for (; i < n; i++) out[i] = lerp_pixel(a[i], b[i], w);
+}
+
+// --- SSE2: horizontal 2 pixels (4 taps), vertical 4 pixels per iteration ---
+
+static void hrow_bilinear_sse2(const uint32_t* s, uint32_t* out, uint32_t n) {
+    __m128i zero = _mm_setzero_si128();
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i p0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s + col_x[i])), zero);
+        __m128i p1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s + col_x[i + 1])), zero);
+        p0 = _mm_mullo_epi16(p0, _mm_load_si128((const __m128i*)col_weight[i]));
+        p1 = _mm_mullo_epi16(p1, _mm_load_si128((const __m128i*)col_weight[i + 1]));
+        __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(p0, p1), _mm_unpackhi_epi64(p0, p1));
+        sum = _mm_srli_epi16(sum, 8);
+        _mm_storel_epi64((__m128i*)(out + i), _mm_packus_epi16(sum, sum));
+    }
+    hrow_bilinear_scalar(s, out, i, n);
+}
+
+static void vrow_sse2(const uint32_t* a, const uint32_t* b, uint32_t* out, uint32_t n, uint32_t w) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i wa = _mm_set1_epi16((short)(256 - w));
+    __m128i wb = _mm_set1_epi16((short)w);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i pa = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i pb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pa, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(pb, zero), wb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pa, zero), wa),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(pb, zero), wb));
+        _mm_storeu_si128((__m128i*)(out + i),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    vrow_scalar(a, b, out, i, n, w);
+}
+
+// --- Row assembly ---
+
+struct ScaleJob {
+    const uint32_t* src;
+    uint32_t src_w;
+    uint32_t src_h;
+    uint32_t src_stride;
+    uint32_t dst_w;
+    uint32_t dst_h;
+    int filter;
+};
+
+static void hscale(const struct ScaleJob* job, uint32_t r, int slot) {
+    const uint32_t* s = job->src + r * job->src_stride;
+    if (job->filter == SCALE_NEAREST || job->src_w < 2) {
+        hrow_nearest(s, hrow[slot], job->dst_w);
+    } else if (simd_features & SIMD_SSE2) {
+        hrow_bilinear_sse2(s, hrow[slot], job->dst_w);
+    } else {
+        hrow_bilinear_scalar(s, hrow[slot], 0, job->dst_w);
+    }
+    hrow_src[slot] = r;
+}
+
+// Destination row dy: a cached horizontal row, or `out` when two source
+// rows had to be blended
+static const uint32_t* scale_row(const struct ScaleJob* job, uint32_t dy, uint32_t* out) {
+    uint32_t r, w;
+    map_axis(dy, job->src_h, job->dst_h, job->filter, &r, &w);
+    if (w == 256) {
+        r++;
+        w = 0;
+    }
+
+    if (hrow_src[0] != r) {
+        if (hrow_src[1] == r) {
+            uint32_t* t = hrow[0]; hrow[0] = hrow[1]; hrow[1] = t;
+            hrow_src[1] = hrow_src[0];
+            hrow_src[0] = r;
+        } else {
+            hscale(job, r, 0);
+        }
+    }
+    if (w == 0) return hrow[0];
+
+    if (hrow_src[1] != r + 1) hscale(job, r + 1, 1);
+    if (simd_features & SIMD_SSE2) {
+        vrow_sse2(hrow[0], hrow[1], out, job->dst_w, w);
+    } else {
+        vrow_scalar(hrow[0], hrow[1], out, 0, job->dst_w, w);
+    }
+    return out;
+}
+
+static int scale_begin(struct ScaleJob* job, const uint32_t* src, uint32_t src_w, uint32_t src_h,
+                       uint32_t src_stride, uint32_t dst_w, uint32_t dst_h, int filter) {
+    if (src_w == 0 || src_h == 0 || dst_w == 0 || dst_h == 0 || dst_w > SCALE_MAX_WIDTH) return 0;
+    job->src = src;
+    job->src_w = src_w;
+    job->src_h = src_h;
+    job->src_stride = src_stride;
+    job->dst_w = dst_w;
+    job->dst_h = dst_h;
+    job->filter = filter;
+    build_plan(src_w, dst_w, filter == SCALE_NEAREST || src_w < 2 ? SCALE_NEAREST : filter);
+    hrow_src[0] = ROW_NONE;
+    hrow_src[1] = ROW_NONE;
+    return 1;
+}
+
+int scale_image(const uint32_t* src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+                uint32_t* dst, uint32_t dst_w, uint32_t dst_h, uint32_t dst_stride, int filter) {
+    struct ScaleJob job;
+    if (!scale_begin(&job, src, src_w, src_h, src_stride, dst_w, dst_h, filter)) return 0;
+    for (uint32_t dy = 0; dy < dst_h; dy++) {
+        uint32_t* out = dst + dy * dst_stride;
+        const uint32_t* row = scale_row(&job, dy, out);
+        if (row != out) span_copy32(out, row, dst_w);
+    }
+    return 1;
+}
+
+int scale_draw(const uint32_t* src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+               int32_t x, int32_t y, uint32_t dst_w, uint32_t dst_h, int filter) {
+    struct ScaleJob job;
+    if (!scale_begin(&job, src, src_w, src_h, src_stride, dst_w, dst_h, filter)) return 0;
+    if (framebuffer_clip_rejects(x, y, (int32_t)dst_w, (int32_t)dst_h)) return 1;
+
+    // Rows are independent: only the ones inside the clip are resampled
+    struct FbRect clip = framebuffer_get_clip();
+    uint32_t dy = (int32_t)clip.y > y ? (uint32_t)((int32_t)clip.y - y) : 0;
+    for (; dy < dst_h && y + (int32_t)dy < (int32_t)(clip.y + clip.h); dy++) {
+        framebuffer_draw_row(x, y + (int32_t)dy, scale_row(&job, dy, out_row), dst_w);
+    }
+    return 1;
+}
@@ -0,0 +1,197 @@
+#include "drivers/display/span.h"
+#include "cpu/simd.h"
+#include <immintrin.h>
+
+// --- Scalar (also used for unaligned heads/tails) ---
+
+static void fill32_scalar(uint32_t* dst, uint32_t color, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) dst[i] = color;
+}
+
+static void copy32_scalar(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) dst[i] = src[i];
+}
+
+// --- SSE2: 4 pixels per store ---
+
+static void fill32_sse2(uint32_t* dst, uint32_t color, uint32_t count) {
+    while (count && ((uint64_t)dst & 15)) { *dst++ = color; count--; }
+    __m128i v = _mm_set1_epi32((int)color);
+    for (; count >= 16; count -= 16, dst += 16) {
+        _mm_store_si128((__m128i*)dst, v);
+        _mm_store_si128((__m128i*)(dst + 4), v);
+        _mm_store_si128((__m128i*)(dst + 8), v);
+        _mm_store_si128((__m128i*)(dst + 12), v);
+    }
+    for (; count >= 4; count -= 4, dst += 4) _mm_store_si128((__m128i*)dst, v);
+    fill32_scalar(dst, color, count);
+}
+
+static void copy32_sse2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    while (count && ((uint64_t)dst & 15)) { *dst++ = *src++; count--; }
+    for (; count >= 8; count -= 8, dst += 8, src += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)src);
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 4));
+        _mm_store_si128((__m128i*)dst, a);
+        _mm_store_si128((__m128i*)(dst + 4), b);
+    }
+    copy32_scalar(dst, src, count);
+}
+
+static void stream32_sse2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    while (count && ((uint64_t)dst & 15)) { *dst++ = *src++; count--; }
+    for (; count >= 16; count -= 16, dst += 16, src += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)src);
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 4));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + 8));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src + 12));
+        _mm_stream_si128((__m128i*)dst, a);
+        _mm_stream_si128((__m128i*)(dst + 4), b);
+        _mm_stream_si128((__m128i*)(dst + 8), c);
+        _mm_stream_si128((__m128i*)(dst + 12), d);
+    }
+    for (; count >= 4; count -= 4, dst += 4, src += 4) {
+        _mm_stream_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+    }
+    copy32_scalar(dst, src, count);
+}
+
+// --- AVX2: 8 pixels per store ---
+
+__attribute__((target("avx2")))
+static void fill32_avx2(uint32_t* dst, uint32_t color, uint32_t count) {
+    while (count && ((uint64_t)dst & 31)) { *dst++ = color; count--; }
+    __m256i v = _mm256_set1_epi32((int)color);
+    for (; count >= 32; count -= 32, dst += 32) {
+        _mm256_store_si256((__m256i*)dst, v);
+        _mm256_store_si256((__m256i*)(dst + 8), v);
+        _mm256_store_si256((__m256i*)(dst + 16), v);
+        _mm256_store_si256((__m256i*)(dst + 24), v);
+    }
+    for (; count >= 8; count -= 8, dst += 8) _mm256_store_si256((__m256i*)dst, v);
+    _mm256_zeroupper();
+    fill32_scalar(dst, color, count);
+}
+
+__attribute__((target("avx2")))
+static void copy32_avx2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    while (count && ((uint64_t)dst & 31)) { *dst++ = *src++; count--; }
+    for (; count >= 16; count -= 16, dst += 16, src += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)src);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + 8));
+        _mm256_store_si256((__m256i*)dst, a);
+        _mm256_store_si256((__m256i*)(dst + 8), b);
+    }
+    _mm256_zeroupper();
+    copy32_scalar(dst, src, count);
+}
+
+__attribute__((target("avx2")))
+static void stream32_avx2(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    while (count && ((uint64_t)dst & 31)) { *dst++ = *src++; count--; }
+    for (; count >= 32; count -= 32, dst += 32, src += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)src);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + 8));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(src + 16));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(src + 24));
+        _mm256_stream_si256((__m256i*)dst, a);
+        _mm256_stream_si256((__m256i*)(dst + 8), b);
+        _mm256_stream_si256((__m256i*)(dst + 16), c);
+        _mm256_stream_si256((__m256i*)(dst + 24), d);
+    }
+    for (; count >= 8; count -= 8, dst += 8, src += 8) {
+        _mm256_stream_si256((__m256i*)dst, _mm256_loadu_si256((const __m256i*)src));
+    }
+    _mm256_zeroupper();
+    copy32_scalar(dst, src, count);
+}
+
+// --- Content hash for dirty-tile comparison ---
+
+uint64_t span_hash32(const uint32_t* src, uint32_t count, uint64_t seed) {
+    uint64_t h = seed ^ 0x9E3779B97F4A7C15ull;
+    const uint64_t* p = (const uint64_t*)src;
+    for (uint32_t i = 0; i < count / 2; i++) {
+        h = (h ^ p[i]) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 29;
+    }
+    if (count & 1) h = (h ^ src[count - 1]) * 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 32;
+    return h ? h : 1; // 0 is reserved for "unknown"
+}
+
+// --- 8-pixel font rows: bit -> pixel expansion through a mask LUT ---
+
+// glyph_masks[bits][col] = 0xFFFFFFFF where bit (7 - col) of bits is set
+static uint32_t glyph_masks[256][8] __attribute__((aligned(16)));
+
+static void glyph8_scalar(uint32_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) {
+    const uint32_t* m = glyph_masks[bits];
+    for (int i = 0; i < 8; i++) dst[i] = (fg & m[i]) | (bg & ~m[i]);
+}
+
+static void glyph8_fg_scalar(uint32_t* dst, uint8_t bits, uint32_t fg) {
+    const uint32_t* m = glyph_masks[bits];
+    for (int i = 0; i < 8; i++) dst[i] = (fg & m[i]) | (dst[i] & ~m[i]);
+}
+
+static void glyph8_sse2(uint32_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) {
+    __m128i f = _mm_set1_epi32((int)fg);
+    __m128i b = _mm_set1_epi32((int)bg);
+    __m128i m0 = _mm_load_si128((const __m128i*)glyph_masks[bits]);
+    __m128i m1 = _mm_load_si128((const __m128i*)(glyph_masks[bits] + 4));
+    _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(m0, f), _mm_andnot_si128(m0, b)));
+    _mm_storeu_si128((__m128i*)(dst + 4), _mm_or_si128(_mm_and_si128(m1, f), _mm_andnot_si128(m1, b)));
+}
+
+static void glyph8_fg_sse2(uint32_t* dst, uint8_t bits, uint32_t fg) {
+    __m128i f = _mm_set1_epi32((int)fg);
+    __m128i m0 = _mm_load_si128((const __m128i*)glyph_masks[bits]);
+    __m128i m1 = _mm_load_si128((const __m128i*)(glyph_masks[bits] + 4));
+    __m128i d0 = _mm_loadu_si128((const __m128i*)dst);
+    __m128i d1 = _mm_loadu_si128((const __m128i*)(dst + 4));
+    _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(m0, f), _mm_andnot_si128(m0, d0)));
+    _mm_storeu_si128((__m128i*)(dst + 4), _mm_or_si128(_mm_and_si128(m1, f), _mm_andnot_si128(m1, d1)));
+}
+
+// Scalar until span_init() runs (SSE must be enabled in CR4 first)
+void (*span_fill32)(uint32_t* dst, uint32_t color, uint32_t count) = fill32_scalar;
+void (*span_copy32)(uint32_t* dst, const uint32_t* src, uint32_t count) = copy32_scalar;
+void (*span_stream32)(uint32_t* dst, const uint32_t* src, uint32_t count) = copy32_scalar;
+void (*span_glyph8)(uint32_t* dst, uint8_t bits, uint32_t fg, uint32_t bg) = glyph8_scalar;
+void (*span_glyph8_fg)(uint32_t* dst, uint8_t bits, uint32_t fg) = glyph8_fg_scalar;
+
+static const char* backend_name = "scalar";
+
+void span_init() {
+    for (int bits = 0; bits < 256; bits++) {
+        for (int col = 0; col < 8; col++) {
+            glyph_masks[bits][col] = (bits & (0x80 >> col)) ? 0xFFFFFFFF : 0;
+        }
+    }
+
+    if (simd_features & SIMD_SSE2) {
+        span_glyph8 = glyph8_sse2;
+        span_glyph8_fg = glyph8_fg_sse2;
+    }
+
+    if (simd_features & SIMD_AVX2) {
+        span_fill32 = fill32_avx2;
+        span_copy32 = copy32_avx2;
+        span_stream32 = stream32_avx2;
+        backend_name = "AVX2";
+    } else if (simd_features & SIMD_SSE2) {
+        span_fill32 = fill32_sse2;
+        span_copy32 = copy32_sse2;
+        span_stream32 = stream32_sse2;
+        backend_name = "SSE2";
+    }
+}
+
+void span_stream_fence() {
+    if (span_stream32 != copy32_scalar) _mm_sfence();
+}
+
+const char* span_backend_name() {
+    return backend_name;
+}
@@ -1,73 +1,154 @@
 #include "drivers/display/text.h"
 #include "drivers/display/font.h"
+#include "drivers/display/glyph_cache.h"
 #include "drivers/framebuffer.h"
 
-void text_draw_char(char c, int x, int y, uint32_t fg, uint32_t bg) {
-    if (c < 32 || c > 127) return;
-
-    // Get the font logic
-    const uint8_t* glyph = font8x8_basic[c - 32];
+// Glyph fully inside the screen: expand each font row straight into the
+// back buffer. Colors are native (packed once by the caller); transparent
+// selects the foreground-only kernel. Caller marks the damage.
+static void draw_glyph_unclipped(const uint8_t* glyph, int x, int y, uint32_t fg, uint32_t bg, int transparent) {
+    const struct PixelOps* ops = framebuffer_pixel_ops();
+    for (int row = 0; row < 8; row++) {
+        uint8_t* dst = framebuffer_back_pixel(x, y + row);
+        if (!transparent) {
+            ops->glyph8(dst, glyph[row], fg, bg);
+        } else {
+            ops->glyph8_fg(dst, glyph[row], fg);
+        }
+    }
+}
 
+// Partially visible glyph: per-pixel path with clipping
+static void draw_glyph_clipped(const uint8_t* glyph, int x, int y, uint32_t fg, uint32_t bg) {
     for (int row = 0; row < 8; row++) {
         uint8_t bits = glyph[row];
         for (int col = 0; col < 8; col++) {
             // Check top bit (0x80)
             if (bits & 0x80) {
                 framebuffer_put_pixel(x + col, y + row, fg);
-            } else {
-                // If bg is NOT transparent (let's say 0 is transparent for now, or just always draw if we want solid box)
-                // For now, let's assume transparent BG if bg == 0, else draw
-                if (bg != 0) {
-                    framebuffer_put_pixel(x + col, y + row, bg);
-                }
+            } else if (bg != 0) {
+                framebuffer_put_pixel(x + col, y + row, bg);
             }
             bits <<= 1;
         }
     }
 }
 
+// Is the w x 8 box entirely inside the clip rectangle?
+static int glyph_box_visible(int x, int y, int w) {
+    struct FbRect clip = framebuffer_get_clip();
+    return x >= (int)clip.x && y >= (int)clip.y &&
+           x + w <= (int)(clip.x + clip.w) && y + 8 <= (int)(clip.y + clip.h);
+}
+
+void text_draw_char(char c, int x, int y, uint32_t fg, uint32_t bg) {
+    if ((unsigned char)c < 32 || (unsigned char)c > 127 || fb.base_address == 0) return;
+    if (framebuffer_clip_rejects(x, y, 8, 8)) return;
+
+    // Get the font logic
+    const uint8_t* glyph = font8x8_basic[c - 32];
+
+    // Clip once per glyph
+    if (glyph_box_visible(x, y, 8)) {
+        draw_glyph_unclipped(glyph, x, y, framebuffer_pack_color(fg), framebuffer_pack_color(bg), bg == 0);
+        framebuffer_mark_dirty(x, y, 8, 8);
+    } else {
+        draw_glyph_clipped(glyph, x, y, fg, bg);
+    }
+}
+
 void text_draw_string(const char* str, int x, int y, uint32_t fg, uint32_t bg) {
-    int cur_x = x;
+    if (fb.base_address == 0) return;
+
+    uint32_t fg_native = framebuffer_pack_color(fg);
+    uint32_t bg_native = framebuffer_pack_color(bg);
+    struct FbRect clip = framebuffer_get_clip();
     int cur_y = y;
-    while (*str) {
+    while (*str && cur_y < (int)(clip.y + clip.h)) { // nothing below the clip
+        // Measure one line, then clip it as a whole
+        int len = 0;
+        while (str[len] && str[len] != '\n') len++;
+
+        // Lines outside the clip are skipped whole; fully visible ones take
+        // the fast path, the rest are clipped glyph by glyph
+        if (len > 0 && !framebuffer_clip_rejects(x, cur_y, len * 8, 8)) {
+            if (glyph_box_visible(x, cur_y, len * 8)) {
+                for (int i = 0; i < len; i++) {
+                    unsigned char c = (unsigned char)str[i];
+                    if (c >= 32 && c <= 127) {
+                        draw_glyph_unclipped(font8x8_basic[c - 32], x + i * 8, cur_y, fg_native, bg_native, bg == 0);
+                    }
+                }
+                framebuffer_mark_dirty(x, cur_y, len * 8, 8);
+            } else {
+                for (int i = 0; i < len; i++) {
+                    text_draw_char(str[i], x + i * 8, cur_y, fg, bg);
+                }
+            }
+        }
+
+        str += len;
         if (*str == '\n') {
-            cur_x = x;
             cur_y += 8;
-        } else {
-            text_draw_char(*str, cur_x, cur_y, fg, bg);
-            cur_x += 8;
+            str++;
         }
-        str++;
     }
 }
 
+// Fill a rect given in signed screen coordinates (clips the negative side)
+static void fill_clipped(int x, int y, int w, int h, uint32_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (w <= 0 || h <= 0) return;
+    framebuffer_draw_rect(x, y, w, h, color);
+}
+
+// Copy a cached (native format) tile with row copies, clipped to the clip rectangle
+static void blit_tile(const uint8_t* tile, int side, int x, int y) {
+    struct FbRect clip = framebuffer_get_clip();
+    int x0 = x < (int)clip.x ? (int)clip.x : x;
+    int y0 = y < (int)clip.y ? (int)clip.y : y;
+    int x1 = x + side > (int)(clip.x + clip.w) ? (int)(clip.x + clip.w) : x + side;
+    int y1 = y + side > (int)(clip.y + clip.h) ? (int)(clip.y + clip.h) : y + side;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const struct PixelOps* ops = framebuffer_pixel_ops();
+    uint32_t bytes = framebuffer_pixel_format()->bytes;
+    for (int row = y0; row < y1; row++) {
+        ops->copy(framebuffer_back_pixel(x0, row), tile + ((row - y) * side + (x0 - x)) * bytes, x1 - x0);
+    }
+    framebuffer_mark_dirty(x0, y0, x1 - x0, y1 - y0);
+}
+
 void text_draw_char_scaled(char c, int x, int y, uint32_t fg, uint32_t bg, int scale) {
-    if (c < 32 || c > 127) return;
+    if ((unsigned char)c < 32 || (unsigned char)c > 127 || scale < 1 || fb.base_address == 0) return;
+    if (framebuffer_clip_rejects(x, y, 8 * scale, 8 * scale)) return;
+    if (scale == 1) {
+        text_draw_char(c, x, y, fg, bg);
+        return;
+    }
 
-    // Get the font logic
-    const uint8_t* glyph = font8x8_basic[c - 32];
+    // Opaque glyphs come pre-rendered from the atlas
+    const uint8_t* tile = glyph_cache_get(c, scale, fg, bg);
+    if (tile) {
+        blit_tile(tile, 8 * scale, x, y);
+        return;
+    }
 
+    // Transparent or oversized: fill runs of set bits as scale-high rects
+    const uint8_t* glyph = font8x8_basic[c - 32];
+    if (bg != 0) {
+        fill_clipped(x, y, 8 * scale, 8 * scale, bg);
+    }
     for (int row = 0; row < 8; row++) {
         uint8_t bits = glyph[row];
-        for (int col = 0; col < 8; col++) {
-            // Check top bit (0x80)
-            if (bits & 0x80) {
-                // Draw pixel scaled
-                for(int dy = 0; dy < scale; dy++) {
-                    for(int dx = 0; dx < scale; dx++) {
-                        framebuffer_put_pixel(x + (col * scale) + dx, y + (row * scale) + dy, fg);
-                    }
-                }
-            } else {
-                if (bg != 0) {
-                     for(int dy = 0; dy < scale; dy++) {
-                        for(int dx = 0; dx < scale; dx++) {
-                            framebuffer_put_pixel(x + (col * scale) + dx, y + (row * scale) + dy, bg);
-                        }
-                    }
-                }
-            }
-            bits <<= 1;
+        int col = 0;
+        while (col < 8) {
+            if (!(bits & (0x80 >> col))) { col++; continue; }
+            int run = col;
+            while (run < 8 && (bits & (0x80 >> run))) run++;
+            fill_clipped(x + col * scale, y + row * scale, (run - col) * scale, scale, fg);
+            col = run;
         }
     }
 }
@@ -87,14 +168,12 @@ void text_draw_string_scaled(const char* str, int x, int y, uint32_t fg, uint32_
     }
 }
 
-// Basic bitmap drawer (row-major, 1 byte per pixel? Or packed?)
-// User asked for "image rendering". Loading standard formats is hard.
-// Let's implement a raw RGBA bitmap drawer.
+// Raw 0xAARRGGBB bitmap (row-major, w * h pixels), drawn opaque one row
+// at a time. QOI/BMP assets go through image_draw() (display/image.h).
 void graphics_draw_bitmap(const uint8_t* bitmap, int x, int y, int w, int h) {
+    if (framebuffer_clip_rejects(x, y, w, h)) return;
     const uint32_t* pixels = (const uint32_t*)bitmap;
     for (int row = 0; row < h; row++) {
-        for (int col = 0; col < w; col++) {
-            framebuffer_put_pixel(x + col, y + row, pixels[row * w + col]);
-        }
+        framebuffer_draw_row(x, y + row, pixels + row * w, w);
     }
 }
@@ -1,27 +1,145 @@
 #include "drivers/framebuffer.h"
+#include "cpu/timer.h"
+#include "drivers/display/span.h"
+#include "drivers/display/bga.h"
+#include "drivers/display/pixel_format.h"
+#include "drivers/display/blend.h"
 
 struct Framebuffer fb = {0};
 
-// Back buffer and dirty-rect tracking
+// Off-screen back buffer in system RAM, stored in the native pixel format so
+// flushes are plain copies. Everything is drawn here and only damaged tiles
+// are copied to (uncached) VRAM in framebuffer_swap().
+// Sized for modes up to FB_BACK_MAX_WIDTH x FB_BACK_MAX_HEIGHT; larger modes
+// fall back to drawing straight into VRAM.
+#define FB_BACK_MAX_WIDTH  1920
+#define FB_BACK_MAX_HEIGHT 1200
+
+static uint32_t back_buffer_mem[FB_BACK_MAX_WIDTH * FB_BACK_MAX_HEIGHT] __attribute__((aligned(64)));
 static uint8_t* back_buffer = 0;
-static int dirty = 0;
-static uint32_t dirty_x1, dirty_y1, dirty_x2, dirty_y2;
-
-static void dirty_mark(uint32_t x, uint32_t y) {
-    if (!dirty) {
-        dirty = 1;
-        dirty_x1 = dirty_x2 = x;
-        dirty_y1 = dirty_y2 = y;
-    } else {
-        if (x < dirty_x1) dirty_x1 = x;
-        if (x > dirty_x2) dirty_x2 = x;
-        if (y < dirty_y1) dirty_y1 = y;
-        if (y > dirty_y2) dirty_y2 = y;
+static uint32_t back_pitch = 0;
+
+// Native pixel layout and the render routines specialized for it
+static struct PixelFormat pixel_format;
+static const struct PixelOps* ops = 0;
+static uint32_t px_bytes = 4;
+// 32 bpp with 8-bit channels below bit 24: the blend kernels work on native
+// pixels directly (xrgb_layout: 0xAARRGGBB sources can be copied as-is)
+static int blend_packed = 0;
+static int xrgb_layout = 0;
+
+// Clip rectangle honoured by every drawing primitive (whole target by default).
+// framebuffer_push_clip() narrows it; the stack holds the rects to restore.
+#define FB_CLIP_STACK_MAX 16
+static struct FbRect clip = {0, 0, 0, 0};
+static struct FbRect clip_stack[FB_CLIP_STACK_MAX];
+static uint32_t clip_depth = 0; // may exceed FB_CLIP_STACK_MAX (ignored pushes)
+
+// Render target: the screen back buffer, or an off-screen target bound with
+// framebuffer_bind_target(). Drawing coordinates stay in screen space.
+static struct FbTarget screen_target;
+static struct FbTarget* target = &screen_target;
+
+// Mouse cursor overlay. It never touches the back buffer: the arrow is
+// composited into the rows it covers while they are flushed to VRAM.
+#define CURSOR_W 12
+#define CURSOR_H 16
+// Translucent drop shadow offset down-right by CURSOR_SHADOW pixels; the
+// overlay box grows by the same amount
+#define CURSOR_SHADOW 2
+#define CURSOR_SHADOW_COLOR 0x50000000 // premultiplied
+#define CURSOR_BOX_W (CURSOR_W + CURSOR_SHADOW)
+#define CURSOR_BOX_H (CURSOR_H + CURSOR_SHADOW)
+
+// Arrow cursor (12x16): 1 = black border, 2 = white fill
+static const uint8_t cursor_arrow[CURSOR_H][CURSOR_W] = {
+    {1,0,0,0,0,0,0,0,0,0,0,0},
+    {1,1,0,0,0,0,0,0,0,0,0,0},
+    {1,2,1,0,0,0,0,0,0,0,0,0},
+    {1,2,2,1,0,0,0,0,0,0,0,0},
+    {1,2,2,2,1,0,0,0,0,0,0,0},
+    {1,2,2,2,2,1,0,0,0,0,0,0},
+    {1,2,2,2,2,2,1,0,0,0,0,0},
+    {1,2,2,2,2,2,2,1,0,0,0,0},
+    {1,2,2,2,2,2,2,2,1,0,0,0},
+    {1,2,2,2,2,2,2,2,2,1,0,0},
+    {1,2,2,2,2,2,1,1,1,1,1,0},
+    {1,2,2,1,2,2,1,0,0,0,0,0},
+    {1,2,1,0,1,2,2,1,0,0,0,0},
+    {1,1,0,0,1,2,2,1,0,0,0,0},
+    {1,0,0,0,0,1,2,2,1,0,0,0},
+    {0,0,0,0,0,1,1,1,1,0,0,0},
+};
+static const uint32_t cursor_colors[3] = { 0, 0xFF000000, 0xFFFFFFFF };
+static uint32_t cursor_native[3];
+
+static uint32_t cursor_x = 0;
+static uint32_t cursor_y = 0;
+static int cursor_visible = 0;
+static uint32_t cursor_row_buf[FB_BACK_MAX_WIDTH] __attribute__((aligned(32))); // native pixels
+
+// Fallback when the back buffer aliases VRAM: classic save-under
+static uint32_t cursor_save_under[CURSOR_W * CURSOR_H];
+
+// Tile-based damage: one dirty bit per FB_TILE x FB_TILE tile. On flush each
+// dirty tile is hashed; tiles whose pixels match what was last sent to VRAM
+// (the GUI often redraws identical content) are skipped.
+#define FB_TILE 64
+#define FB_TILE_SHIFT 6
+#define FB_MAX_TILE_COLS ((FB_BACK_MAX_WIDTH + FB_TILE - 1) / FB_TILE)  // <= 64 bits
+#define FB_MAX_TILE_ROWS ((FB_BACK_MAX_HEIGHT + FB_TILE - 1) / FB_TILE)
+#define FB_TILE_HASH_INVALID 0 // span_hash32 never returns 0
+
+static uint64_t tile_dirty[FB_MAX_TILE_ROWS];
+// One hash set per VRAM page (two when page flipping)
+static uint64_t tile_hash[2][FB_MAX_TILE_ROWS][FB_MAX_TILE_COLS];
+static uint32_t tile_cols = 0;
+static uint32_t tile_rows = 0;
+static int damage_pending = 0;
+static struct FbStats stats = {0};
+
+// Bitmask of tile columns [c0, c1]
+static uint64_t tile_col_mask(uint32_t c0, uint32_t c1) {
+    uint64_t hi = (c1 >= 63) ? ~0ull : ((1ull << (c1 + 1)) - 1);
+    return hi & ~((1ull << c0) - 1);
+}
+
+static void damage_add(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint64_t mask = tile_col_mask(x >> FB_TILE_SHIFT, (x + w - 1) >> FB_TILE_SHIFT);
+    uint32_t r1 = (y + h - 1) >> FB_TILE_SHIFT;
+    for (uint32_t r = y >> FB_TILE_SHIFT; r <= r1; r++) {
+        tile_dirty[r] |= mask;
     }
+    damage_pending = 1;
 }
 
-static void dirty_reset(void) {
-    dirty = 0;
+static void damage_reset(void) {
+    for (uint32_t r = 0; r < tile_rows; r++) tile_dirty[r] = 0;
+    damage_pending = 0;
+}
+
+// Forget what a VRAM page holds for the tiles covering a rect (forces next flush)
+static void tile_hash_invalidate(int page, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    for (uint32_t r = y >> FB_TILE_SHIFT; r <= (y + h - 1) >> FB_TILE_SHIFT; r++) {
+        for (uint32_t c = x >> FB_TILE_SHIFT; c <= (x + w - 1) >> FB_TILE_SHIFT; c++) {
+            tile_hash[page][r][c] = FB_TILE_HASH_INVALID;
+        }
+    }
+}
+
+// BGA page flipping: VRAM holds two screens stacked vertically. Frames are
+// flushed into the hidden page, then the scanout Y offset is switched at
+// vblank. The hidden page is one frame behind, so each swap flushes this
+// frame's dirty tiles plus the previous frame's.
+static int flip_enabled = 0;
+static int front_page = 0;
+static uint64_t prev_dirty[FB_MAX_TILE_ROWS];
+
+// VRAM page currently written by flushes
+static uint8_t* vram_target = 0;
+
+static uint8_t* vram_page(int page) {
+    return (uint8_t*)fb.base_address + (size_t)page * fb.height * fb.pitch;
 }
 
 struct multiboot_tag {
@@ -37,9 +155,27 @@ struct multiboot_tag_framebuffer {
     uint32_t height;
     uint8_t bpp;
     uint8_t type;
-    uint8_t reserved;
+    uint16_t reserved;
+    // Color info for type 1 (direct RGB)
+    uint8_t red_pos;
+    uint8_t red_size;
+    uint8_t green_pos;
+    uint8_t green_size;
+    uint8_t blue_pos;
+    uint8_t blue_size;
 };
 
+#define MULTIBOOT_FB_TYPE_RGB 1
+
+// Read one native pixel (the write side goes through ops->fill)
+static uint32_t load_pixel(const uint8_t* p) {
+    switch (px_bytes) {
+        case 2: return *(const uint16_t*)p;
+        case 3: return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16);
+        default: return *(const uint32_t*)p;
+    }
+}
+
 void framebuffer_init(void* mboot_addr) {
     struct multiboot_tag* tag;
     uint32_t* addr = (uint32_t*) mboot_addr;
@@ -56,7 +192,48 @@ void framebuffer_init(void* mboot_addr) {
              fb.pitch = fb_tag->pitch;
              fb.bpp = fb_tag->bpp;
              fb.buffer_size = fb.pitch * fb.height;
-             back_buffer = (uint8_t*)fb.base_address;
+
+             // Unknown layouts keep the old assumption of 32 bpp xRGB
+             if (fb_tag->type != MULTIBOOT_FB_TYPE_RGB ||
+                 !pixel_format_from_tag(&pixel_format, fb_tag->bpp,
+                                        fb_tag->red_pos, fb_tag->red_size,
+                                        fb_tag->green_pos, fb_tag->green_size,
+                                        fb_tag->blue_pos, fb_tag->blue_size)) {
+                 pixel_format = pixel_format_xrgb8888;
+             }
+             ops = pixel_format_ops(&pixel_format);
+             px_bytes = pixel_format.bytes;
+             blend_packed = px_bytes == 4 && pixel_format.red_size == 8 &&
+                            pixel_format.green_size == 8 && pixel_format.blue_size == 8 &&
+                            pixel_format.red_pos < 24 && pixel_format.green_pos < 24 &&
+                            pixel_format.blue_pos < 24;
+             xrgb_layout = blend_packed && pixel_format.red_pos == 16 &&
+                          pixel_format.green_pos == 8 && pixel_format.blue_pos == 0;
+             for (int i = 0; i < 3; i++) cursor_native[i] = pixel_pack(&pixel_format, cursor_colors[i]);
+
+             if (fb.width <= FB_BACK_MAX_WIDTH && fb.height <= FB_BACK_MAX_HEIGHT) {
+                 back_buffer = (uint8_t*)back_buffer_mem;
+                 back_pitch = fb.width * px_bytes;
+                 tile_cols = (fb.width + FB_TILE - 1) / FB_TILE;
+                 tile_rows = (fb.height + FB_TILE - 1) / FB_TILE;
+                 tile_hash_invalidate(0, 0, 0, fb.width, fb.height);
+             } else {
+                 // Mode too large for the static back buffer: draw directly to VRAM
+                 back_buffer = (uint8_t*)fb.base_address;
+                 back_pitch = fb.pitch;
+                 tile_cols = 0;
+                 tile_rows = 0;
+             }
+             screen_target.pixels = back_buffer;
+             screen_target.pitch = back_pitch;
+             screen_target.x = 0;
+             screen_target.y = 0;
+             screen_target.width = fb.width;
+             screen_target.height = fb.height;
+             target = &screen_target;
+             vram_target = (uint8_t*)fb.base_address;
+             damage_reset();
+             framebuffer_reset_clip();
              return;
         }
         
@@ -65,121 +242,534 @@ void framebuffer_init(void* mboot_addr) {
     }
 }
 
+// Direct access to a back buffer pixel for span renderers (native format,
+// see framebuffer_pixel_ops); callers clip and report what they touched
+// through framebuffer_mark_dirty().
+uint8_t* framebuffer_back_pixel(uint32_t x, uint32_t y) {
+    return target->pixels + (y - target->y) * target->pitch + (x - target->x) * px_bytes;
+}
+
+// Record drawing in screen space: screen tiles, or the bound target's box
+static void target_damage(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (target == &screen_target) {
+        if (tile_rows) damage_add(x, y, w, h);
+        return;
+    }
+    struct FbRect* d = &target->dirty;
+    if (d->w == 0) {
+        d->x = x; d->y = y; d->w = w; d->h = h;
+        return;
+    }
+    uint32_t x2 = (x + w > d->x + d->w) ? x + w : d->x + d->w;
+    uint32_t y2 = (y + h > d->y + d->h) ? y + h : d->y + d->h;
+    if (x < d->x) d->x = x;
+    if (y < d->y) d->y = y;
+    d->w = x2 - d->x;
+    d->h = y2 - d->y;
+}
+
+// Redirect all drawing into t (0 = back to the screen). The clip resets to
+// the whole target.
+void framebuffer_bind_target(struct FbTarget* t) {
+    target = t ? t : &screen_target;
+    framebuffer_reset_clip();
+}
+
+// Copy a screen-space rect of src into the screen back buffer
+void framebuffer_compose(const struct FbTarget* src, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (fb.base_address == 0 || w == 0 || h == 0) return;
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < src->x) x = src->x;
+    if (y < src->y) y = src->y;
+    if (x2 > src->x + src->width) x2 = src->x + src->width;
+    if (y2 > src->y + src->height) y2 = src->y + src->height;
+    if (x2 > fb.width) x2 = fb.width;
+    if (y2 > fb.height) y2 = fb.height;
+    if (x >= x2 || y >= y2) return;
+
+    const uint8_t* from = src->pixels + (y - src->y) * src->pitch + (x - src->x) * px_bytes;
+    uint8_t* to = back_buffer + y * back_pitch + x * px_bytes;
+    for (uint32_t row = y; row < y2; row++) {
+        ops->copy(to, from, x2 - x);
+        from += src->pitch;
+        to += back_pitch;
+    }
+    if (tile_rows) damage_add(x, y, x2 - x, y2 - y);
+}
+
+const struct PixelOps* framebuffer_pixel_ops(void) {
+    return ops;
+}
+
+const struct PixelFormat* framebuffer_pixel_format(void) {
+    return &pixel_format;
+}
+
+uint32_t framebuffer_pack_color(uint32_t argb) {
+    return pixel_pack(&pixel_format, argb);
+}
+
+void framebuffer_mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (fb.base_address == 0 || w == 0 || h == 0) return;
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < target->x) x = target->x;
+    if (y < target->y) y = target->y;
+    if (x2 > target->x + target->width) x2 = target->x + target->width;
+    if (y2 > target->y + target->height) y2 = target->y + target->height;
+    if (x >= x2 || y >= y2) return;
+    target_damage(x, y, x2 - x, y2 - y);
+}
+
+// The clip is kept inside the bound target
+void framebuffer_set_clip(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < target->x) x = target->x;
+    if (y < target->y) y = target->y;
+    if (x2 > target->x + target->width) x2 = target->x + target->width;
+    if (y2 > target->y + target->height) y2 = target->y + target->height;
+    clip.x = x;
+    clip.y = y;
+    clip.w = x2 > x ? x2 - x : 0;
+    clip.h = y2 > y ? y2 - y : 0;
+}
+
+// Back to the whole target with an empty clip stack
+void framebuffer_reset_clip(void) {
+    clip_depth = 0;
+    framebuffer_set_clip(target->x, target->y, target->width, target->height);
+}
+
+// Narrow the clip to its intersection with a rect (signed: may start off
+// screen). Pushes beyond FB_CLIP_STACK_MAX leave the clip unchanged.
+void framebuffer_push_clip(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (clip_depth++ >= FB_CLIP_STACK_MAX) return;
+    clip_stack[clip_depth - 1] = clip;
+
+    int32_t x1 = x > (int32_t)clip.x ? x : (int32_t)clip.x;
+    int32_t y1 = y > (int32_t)clip.y ? y : (int32_t)clip.y;
+    int32_t x2 = x + w < (int32_t)(clip.x + clip.w) ? x + w : (int32_t)(clip.x + clip.w);
+    int32_t y2 = y + h < (int32_t)(clip.y + clip.h) ? y + h : (int32_t)(clip.y + clip.h);
+    if (x1 >= x2 || y1 >= y2) {
+        clip.w = 0;
+        clip.h = 0;
+        return;
+    }
+    clip.x = x1;
+    clip.y = y1;
+    clip.w = x2 - x1;
+    clip.h = y2 - y1;
+}
+
+void framebuffer_pop_clip(void) {
+    if (clip_depth == 0) return;
+    if (--clip_depth < FB_CLIP_STACK_MAX) clip = clip_stack[clip_depth];
+}
+
+// Trivial reject: is the box entirely outside the clip?
+int framebuffer_clip_rejects(int32_t x, int32_t y, int32_t w, int32_t h) {
+    return w <= 0 || h <= 0 || clip.w == 0 ||
+           x >= (int32_t)(clip.x + clip.w) || y >= (int32_t)(clip.y + clip.h) ||
+           x + w <= (int32_t)clip.x || y + h <= (int32_t)clip.y;
+}
+
+struct FbRect framebuffer_get_clip(void) {
+    return clip;
+}
+
 void framebuffer_put_pixel(uint32_t x, uint32_t y, uint32_t color) {
-    if (x >= fb.width || y >= fb.height || fb.base_address == 0) return;
+    if (x - clip.x >= clip.w || y - clip.y >= clip.h || fb.base_address == 0) return;
     
-    // Assuming 32 bpp (ARGB/RGBA)
-    uint32_t* pixel = (uint32_t*)((uint8_t*)fb.base_address + y * fb.pitch + x * 4);
-    *pixel = color;
+    ops->fill(framebuffer_back_pixel(x, y), pixel_pack(&pixel_format, color), 1);
+    target_damage(x, y, 1, 1);
 }
 
 uint32_t framebuffer_get_pixel(uint32_t x, uint32_t y) {
-    if (x >= fb.width || y >= fb.height || fb.base_address == 0) return 0;
-    
-    // Assuming 32 bpp (ARGB/RGBA)
-    uint32_t* pixel = (uint32_t*)((uint8_t*)fb.base_address + y * fb.pitch + x * 4);
-    return *pixel;
+    if (fb.base_address == 0 || x - target->x >= target->width || y - target->y >= target->height) return 0;
+
+    return pixel_unpack(&pixel_format, load_pixel(framebuffer_back_pixel(x, y)));
 }
 
-void framebuffer_swap(void) {
-    if (fb.base_address == 0 || fb.buffer_size == 0 || !dirty) return;
+// Blend a premultiplied 0xAARRGGBB color over count native pixels
+void framebuffer_blend_native(uint8_t* dst, uint32_t premul, uint32_t count) {
+    if (blend_packed) {
+        blend_fill32((uint32_t*)dst, pixel_pack(&pixel_format, premul) | (premul & 0xFF000000), count);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++, dst += px_bytes) {
+        uint32_t d = pixel_unpack(&pixel_format, load_pixel(dst));
+        ops->fill(dst, pixel_pack(&pixel_format, blend_over(d, premul)), 1);
+    }
+}
+
+// Flush one row segment, compositing the cursor if it overlaps
+static void flush_row(uint32_t row, uint32_t x, uint32_t w) {
+    uint8_t* dst = vram_target + row * fb.pitch + x * px_bytes;
+    uint8_t* src = back_buffer + row * back_pitch + x * px_bytes;
+
+    if (!cursor_visible || row < cursor_y || row >= cursor_y + CURSOR_BOX_H ||
+        x >= cursor_x + CURSOR_BOX_W || x + w <= cursor_x) {
+        ops->stream(dst, src, w);
+        return;
+    }
+
+    // Keep the staging row at the same dword alignment as the destination
+    uint8_t* buf = (uint8_t*)cursor_row_buf + ((uintptr_t)dst & 3);
+    ops->copy(buf, src, w);
+    uint32_t r = row - cursor_y;
+    const uint8_t* shape = r < CURSOR_H ? cursor_arrow[r] : 0;
+    const uint8_t* shadow = r >= CURSOR_SHADOW ? cursor_arrow[r - CURSOR_SHADOW] : 0;
+    for (uint32_t col = 0; col < CURSOR_BOX_W; col++) {
+        uint32_t sx = cursor_x + col;
+        if (sx < x || sx >= x + w) continue;
+        uint8_t* px = buf + (sx - x) * px_bytes;
+        if (shape && col < CURSOR_W && shape[col]) {
+            ops->fill(px, cursor_native[shape[col]], 1);
+        } else if (shadow && col >= CURSOR_SHADOW && shadow[col - CURSOR_SHADOW]) {
+            framebuffer_blend_native(px, CURSOR_SHADOW_COLOR, 1);
+        }
+    }
+    ops->stream(dst, buf, w);
+}
+
+// Copy one rectangle from the back buffer to VRAM with streaming stores.
+// Callers fence once after the whole flush.
+static void copy_rect_to_vram(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    for (uint32_t row = y; row < y + h; row++) {
+        flush_row(row, x, w);
+    }
+}
+
+static void cursor_save_restore(int save) {
+    for (uint32_t row = 0; row < CURSOR_H && cursor_y + row < fb.height; row++) {
+        uint8_t* px = back_buffer + (cursor_y + row) * back_pitch + cursor_x * px_bytes;
+        for (uint32_t col = 0; col < CURSOR_W && cursor_x + col < fb.width; col++) {
+            uint32_t* saved = &cursor_save_under[row * CURSOR_W + col];
+            if (save) {
+                *saved = load_pixel(px + col * px_bytes);
+                if (cursor_arrow[row][col]) ops->fill(px + col * px_bytes, cursor_native[cursor_arrow[row][col]], 1);
+            } else {
+                ops->fill(px + col * px_bytes, *saved, 1);
+            }
+        }
+    }
+}
 
-    // Only copy the dirty rectangle to VRAM
-    uint32_t x = dirty_x1;
-    uint32_t y = dirty_y1;
-    uint32_t w = dirty_x2 - dirty_x1 + 1;
-    uint32_t h = dirty_y2 - dirty_y1 + 1;
+// Move/show the cursor overlay. Only the old and new cursor rects are
+// damaged; the next framebuffer_swap() composites the arrow on the fly.
+void framebuffer_set_cursor(uint32_t x, uint32_t y, int visible) {
+    if (fb.base_address == 0) return;
+    if (visible == cursor_visible && x == cursor_x && y == cursor_y) return;
+
+    if (back_buffer == (uint8_t*)fb.base_address) {
+        if (cursor_visible) cursor_save_restore(0);
+        cursor_x = x;
+        cursor_y = y;
+        cursor_visible = visible;
+        if (cursor_visible) cursor_save_restore(1);
+        return;
+    }
+
+    if (cursor_visible) framebuffer_mark_dirty(cursor_x, cursor_y, CURSOR_BOX_W, CURSOR_BOX_H);
+    cursor_x = x;
+    cursor_y = y;
+    cursor_visible = visible;
+    if (cursor_visible) framebuffer_mark_dirty(cursor_x, cursor_y, CURSOR_BOX_W, CURSOR_BOX_H);
+}
 
+// Hash one tile of the back buffer as it would appear in VRAM. Rows are
+// hashed as whole dwords; for 16/24 bpp this may take in up to 3 bytes of
+// the next pixel, which can only cause a spurious flush.
+static uint64_t tile_content_hash(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint64_t hsh = 0;
+    uint32_t words = (w * px_bytes + 3) / 4;
     for (uint32_t row = y; row < y + h; row++) {
-        uint64_t* dst = (uint64_t*)((uint8_t*)fb.base_address + row * fb.pitch + (x & ~1) * 4);
-        uint64_t* src = (uint64_t*)(back_buffer + row * fb.pitch + (x & ~1) * 4);
-        uint32_t qwords = ((w + (x & 1) + 1) / 2);
-        for (uint32_t i = 0; i < qwords; i++) {
-            dst[i] = src[i];
+        hsh = span_hash32((const uint32_t*)(back_buffer + row * back_pitch + x * px_bytes), words, hsh);
+    }
+    return hsh;
+}
+
+static int tile_under_cursor(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    return cursor_visible && cursor_x < x + w && cursor_x + CURSOR_BOX_W > x &&
+           cursor_y < y + h && cursor_y + CURSOR_BOX_H > y;
+}
+
+void framebuffer_swap(void) {
+    if (fb.base_address == 0 || fb.buffer_size == 0 || !damage_pending) return;
+
+    // Back buffer aliases VRAM: nothing to copy
+    if (back_buffer == (uint8_t*)fb.base_address) {
+        damage_pending = 0;
+        return;
+    }
+
+    int page = flip_enabled ? 1 - front_page : 0;
+    vram_target = vram_page(page);
+
+    // Walk dirty tiles row by row, flushing runs of changed tiles as one span
+    for (uint32_t r = 0; r < tile_rows; r++) {
+        uint64_t bits = tile_dirty[r];
+        if (flip_enabled) {
+            bits |= prev_dirty[r];
+            prev_dirty[r] = tile_dirty[r];
         }
+        if (!bits) continue;
+
+        uint32_t y = r * FB_TILE;
+        uint32_t h = (y + FB_TILE > fb.height) ? fb.height - y : FB_TILE;
+        uint32_t run_start = 0, run_len = 0;
+
+        for (uint32_t c = 0; c <= tile_cols; c++) {
+            int flush = 0;
+            if (c < tile_cols && (bits & (1ull << c))) {
+                uint32_t x = c * FB_TILE;
+                uint32_t w = (x + FB_TILE > fb.width) ? fb.width - x : FB_TILE;
+                if (tile_under_cursor(x, y, w, h)) {
+                    // VRAM will hold the composited cursor, not the back buffer
+                    tile_hash[page][r][c] = FB_TILE_HASH_INVALID;
+                    flush = 1;
+                } else {
+                    uint64_t hsh = tile_content_hash(x, y, w, h);
+                    if (hsh != tile_hash[page][r][c]) {
+                        tile_hash[page][r][c] = hsh;
+                        flush = 1;
+                    } else {
+                        stats.tiles_skipped++;
+                    }
+                }
+            }
+
+            if (flush) {
+                if (run_len == 0) run_start = c;
+                run_len++;
+                stats.tiles_flushed++;
+            } else if (run_len > 0) {
+                uint32_t x = run_start * FB_TILE;
+                uint32_t x_end = (run_start + run_len) * FB_TILE;
+                if (x_end > fb.width) x_end = fb.width;
+                copy_rect_to_vram(x, y, x_end - x, h);
+                run_len = 0;
+            }
+        }
+    }
+    span_stream_fence();
+
+    if (flip_enabled) {
+        bga_wait_vblank();
+        bga_set_y_offset(page * fb.height);
+        front_page = page;
+        stats.page_flips++;
     }
 
-    dirty_reset();
+    damage_reset();
+}
+
+// Switch to BGA double buffering in VRAM. Needs the RAM back buffer, a
+// 32 bpp BGA mode and room for two screens. Returns 1 if flipping is on.
+int framebuffer_enable_page_flip(void) {
+    if (fb.base_address == 0 || back_buffer == (uint8_t*)fb.base_address) return 0;
+    // The virtual width below is pitch / px_bytes, which a padded 24 or
+    // 16 bpp pitch does not divide into; only 32 bpp modes are flipped
+    if (px_bytes != 4) return 0;
+    if (!bga_available()) return 0;
+    if (bga_vram_size() < 2 * fb.buffer_size) return 0;
+
+    bga_set_mode(fb.width, fb.height, fb.bpp);
+    if (!bga_set_virtual(fb.pitch / px_bytes, fb.height * 2)) {
+        bga_set_virtual(fb.pitch / px_bytes, fb.height);
+        return 0;
+    }
+
+    // Page 0 is on screen; both pages get a full flush over the next two swaps
+    flip_enabled = 1;
+    front_page = 0;
+    tile_hash_invalidate(0, 0, 0, fb.width, fb.height);
+    tile_hash_invalidate(1, 0, 0, fb.width, fb.height);
+    damage_add(0, 0, fb.width, fb.height);
+    for (uint32_t r = 0; r < tile_rows; r++) prev_dirty[r] = tile_dirty[r];
+    return 1;
+}
+
+struct FbStats framebuffer_get_stats(void) {
+    return stats;
 }
 
 void framebuffer_blit_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
-    if (fb.base_address == 0) return;
+    if (fb.base_address == 0 || back_buffer == (uint8_t*)fb.base_address) return;
 
     // Clamp to screen bounds
     if (x >= fb.width || y >= fb.height) return;
     if (x + w > fb.width) w = fb.width - x;
     if (y + h > fb.height) h = fb.height - y;
 
-    // Copy rectangle from back buffer to video memory using 64-bit writes
-    for (uint32_t row = y; row < y + h; row++) {
-        uint64_t* dst = (uint64_t*)((uint8_t*)fb.base_address + row * fb.pitch + (x & ~1) * 4);
-        uint64_t* src = (uint64_t*)(back_buffer + row * fb.pitch + (x & ~1) * 4);
-        uint32_t qwords = ((w + (x & 1) + 1) / 2);
-        for (uint32_t i = 0; i < qwords; i++) {
-            dst[i] = src[i];
+    // Immediate blits go to the page on screen
+    int page = flip_enabled ? front_page : 0;
+    vram_target = vram_page(page);
+    copy_rect_to_vram(x, y, w, h);
+    span_stream_fence();
+    tile_hash_invalidate(page, x, y, w, h);
+}
+
+// Blit the full back buffer to VRAM for FB_BENCH_TICKS and return MB/s.
+// Needs the PIT (100 Hz) running with interrupts enabled.
+#define FB_BENCH_TICKS 10
+
+uint32_t framebuffer_measure_bandwidth(void) {
+    if (fb.base_address == 0 || back_buffer == (uint8_t*)fb.base_address) return 0;
+
+    // Start on a tick edge
+    uint64_t start = get_tick_count();
+    while (get_tick_count() == start) asm volatile("pause");
+    start = get_tick_count();
+
+    int page = flip_enabled ? front_page : 0;
+    vram_target = vram_page(page);
+    tile_hash_invalidate(page, 0, 0, fb.width, fb.height);
+
+    uint64_t bytes = 0;
+    uint64_t now;
+    do {
+        copy_rect_to_vram(0, 0, fb.width, fb.height);
+        span_stream_fence();
+        bytes += (uint64_t)fb.width * fb.height * px_bytes;
+        now = get_tick_count();
+    } while (now - start < FB_BENCH_TICKS);
+
+    return (uint32_t)((bytes * 100) / ((now - start) * 1024 * 1024));
+}
+
+// Move the pixels of a rect by dy rows (negative = up) inside the bound
+// target. Rows are copied in the order that never overwrites unread source
+// rows; the |dy| rows uncovered at one edge keep stale pixels for the
+// caller to repaint.
+void framebuffer_scroll_region(uint32_t x, uint32_t y, uint32_t w, uint32_t h, int32_t dy) {
+    if (fb.base_address == 0 || w == 0 || h == 0 || dy == 0) return;
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < target->x) x = target->x;
+    if (y < target->y) y = target->y;
+    if (x2 > target->x + target->width) x2 = target->x + target->width;
+    if (y2 > target->y + target->height) y2 = target->y + target->height;
+    if (x >= x2 || y >= y2) return;
+    w = x2 - x;
+    h = y2 - y;
+
+    uint32_t shift = dy < 0 ? (uint32_t)-dy : (uint32_t)dy;
+    if (shift < h) {
+        uint32_t rows = h - shift;
+        if (dy < 0) {
+            for (uint32_t r = 0; r < rows; r++) {
+                ops->copy(framebuffer_back_pixel(x, y + r), framebuffer_back_pixel(x, y + r + shift), w);
+            }
+        } else {
+            for (uint32_t r = rows; r-- > 0;) {
+                ops->copy(framebuffer_back_pixel(x, y + r + shift), framebuffer_back_pixel(x, y + r), w);
+            }
         }
     }
+    target_damage(x, y, w, h);
 }
 
+// Clears the whole bound target regardless of the clip rectangle
 void framebuffer_clear(uint32_t color) {
     if (fb.base_address == 0) return;
     
-    for (uint32_t y = 0; y < fb.height; y++) {
-        uint32_t* row = (uint32_t*)(back_buffer + y * fb.pitch);
-        for (uint32_t x = 0; x < fb.width; x++) {
-            row[x] = color;
-        }
+    uint32_t native = pixel_pack(&pixel_format, color);
+    for (uint32_t y = 0; y < target->height; y++) {
+        ops->fill(target->pixels + y * target->pitch, native, target->width);
     }
-    dirty_mark(0, 0);
-    dirty_mark(fb.width - 1, fb.height - 1);
+    target_damage(target->x, target->y, target->width, target->height);
 }
 
 void framebuffer_draw_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color) {
     if (fb.base_address == 0 || w == 0 || h == 0) return;
 
-    // Clamp to screen bounds
-    if (x >= fb.width || y >= fb.height) return;
-    if (x + w > fb.width) w = fb.width - x;
-    if (y + h > fb.height) h = fb.height - y;
+    // Clamp to the clip rectangle
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < clip.x) x = clip.x;
+    if (y < clip.y) y = clip.y;
+    if (x2 > clip.x + clip.w) x2 = clip.x + clip.w;
+    if (y2 > clip.y + clip.h) y2 = clip.y + clip.h;
+    if (x >= x2 || y >= y2) return;
+    w = x2 - x;
+    h = y2 - y;
 
+    uint32_t native = pixel_pack(&pixel_format, color);
+    uint8_t* dst = framebuffer_back_pixel(x, y);
     for (uint32_t row = 0; row < h; row++) {
-        uint32_t* dst = (uint32_t*)(back_buffer + (y + row) * fb.pitch + x * 4);
-        for (uint32_t col = 0; col < w; col++) {
-            dst[col] = color;
+        ops->fill(dst, native, w);
+        dst += target->pitch;
+    }
+    target_damage(x, y, w, h);
+}
+
+// Opaque row of 0xAARRGGBB pixels starting at (x, y); alpha is ignored.
+// On xRGB8888 the row is a straight span copy.
+void framebuffer_draw_row(int32_t x, int32_t y, const uint32_t* argb, uint32_t count) {
+    if (fb.base_address == 0 || framebuffer_clip_rejects(x, y, (int32_t)count, 1)) return;
+
+    int32_t x1 = x > (int32_t)clip.x ? x : (int32_t)clip.x;
+    int32_t x2 = x + (int32_t)count < (int32_t)(clip.x + clip.w) ? x + (int32_t)count : (int32_t)(clip.x + clip.w);
+    uint32_t n = x2 - x1;
+    const uint32_t* src = argb + (x1 - x);
+    uint8_t* dst = framebuffer_back_pixel(x1, y);
+    if (xrgb_layout) {
+        span_copy32((uint32_t*)dst, src, n);
+    } else {
+        for (uint32_t i = 0; i < n; i++, dst += px_bytes) {
+            ops->fill(dst, pixel_pack(&pixel_format, src[i]), 1);
         }
     }
-    dirty_mark(x, y);
-    dirty_mark(x + w - 1, y + h - 1);
-}
-
-void framebuffer_draw_cursor(uint32_t x, uint32_t y) {
-    // Arrow cursor (12x16) - drawn as filled triangle with border
-    // Row by row: width increases as we go down, with a notch for the tail
-    static const uint8_t arrow[16][12] = {
-        {1,0,0,0,0,0,0,0,0,0,0,0},
-        {1,1,0,0,0,0,0,0,0,0,0,0},
-        {1,2,1,0,0,0,0,0,0,0,0,0},
-        {1,2,2,1,0,0,0,0,0,0,0,0},
-        {1,2,2,2,1,0,0,0,0,0,0,0},
-        {1,2,2,2,2,1,0,0,0,0,0,0},
-        {1,2,2,2,2,2,1,0,0,0,0,0},
-        {1,2,2,2,2,2,2,1,0,0,0,0},
-        {1,2,2,2,2,2,2,2,1,0,0,0},
-        {1,2,2,2,2,2,2,2,2,1,0,0},
-        {1,2,2,2,2,2,1,1,1,1,1,0},
-        {1,2,2,1,2,2,1,0,0,0,0,0},
-        {1,2,1,0,1,2,2,1,0,0,0,0},
-        {1,1,0,0,1,2,2,1,0,0,0,0},
-        {1,0,0,0,0,1,2,2,1,0,0,0},
-        {0,0,0,0,0,1,1,1,1,0,0,0},
-    };
-    for (int row = 0; row < 16; row++) {
-        for (int col = 0; col < 12; col++) {
-            if (arrow[row][col] == 1) {
-                framebuffer_put_pixel(x + col, y + row, 0xFF000000); // Black border
-            } else if (arrow[row][col] == 2) {
-                framebuffer_put_pixel(x + col, y + row, 0xFFFFFFFF); // White fill
-            }
+    target_damage(x1, y, n, 1);
+}
+
+// Translucent fill: argb is a straight (non-premultiplied) color
+void framebuffer_blend_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t argb) {
+    if ((argb >> 24) == 0xFF) {
+        framebuffer_draw_rect(x, y, w, h, argb);
+        return;
+    }
+    if (fb.base_address == 0 || w == 0 || h == 0 || (argb >> 24) == 0) return;
+
+    uint32_t x2 = x + w, y2 = y + h;
+    if (x < clip.x) x = clip.x;
+    if (y < clip.y) y = clip.y;
+    if (x2 > clip.x + clip.w) x2 = clip.x + clip.w;
+    if (y2 > clip.y + clip.h) y2 = clip.y + clip.h;
+    if (x >= x2 || y >= y2) return;
+    w = x2 - x;
+    h = y2 - y;
+
+    uint32_t premul = blend_premultiply(argb);
+    uint8_t* dst = framebuffer_back_pixel(x, y);
+    for (uint32_t row = 0; row < h; row++) {
+        framebuffer_blend_native(dst, premul, w);
+        dst += target->pitch;
+    }
+    target_damage(x, y, w, h);
+}
+
+// Blend a premultiplied 0xAARRGGBB bitmap (stride in pixels) with its
+// top-left corner at (x, y), which may lie outside the clip
+void framebuffer_blend_bitmap(const uint32_t* pixels, int32_t x, int32_t y, uint32_t w, uint32_t h, uint32_t stride) {
+    if (fb.base_address == 0 || framebuffer_clip_rejects(x, y, (int32_t)w, (int32_t)h)) return;
+
+    int32_t x1 = x > (int32_t)clip.x ? x : (int32_t)clip.x;
+    int32_t y1 = y > (int32_t)clip.y ? y : (int32_t)clip.y;
+    int32_t x2 = x + (int32_t)w < (int32_t)(clip.x + clip.w) ? x + (int32_t)w : (int32_t)(clip.x + clip.w);
+    int32_t y2 = y + (int32_t)h < (int32_t)(clip.y + clip.h) ? y + (int32_t)h : (int32_t)(clip.y + clip.h);
+    uint32_t cw = x2 - x1;
+
+    const uint32_t* src = pixels + (y1 - y) * stride + (x1 - x);
+    for (int32_t row = y1; row < y2; row++, src += stride) {
+        uint8_t* dst = framebuffer_back_pixel(x1, row);
+        if (xrgb_layout) {
+            blend_span32((uint32_t*)dst, src, cw);
+            continue;
+        }
+        for (uint32_t i = 0; i < cw; i++, dst += px_bytes) {
+            if ((src[i] >> 24) == 0) continue;
+            uint32_t d = pixel_unpack(&pixel_format, load_pixel(dst));
+            ops->fill(dst, pixel_pack(&pixel_format, blend_over(d, src[i])), 1);
         }
     }
+    target_damage(x1, y1, cw, y2 - y1);
 }
@@ -11,6 +11,7 @@
 #include "drivers/keyboard.h"
 #include "util/io.h"
 #include "cpu/isr.h"
+#include "mm/heap.h"
 
 // Interrupt-Driven Keyboard Driver with Modifiers
 
@@ -46,8 +47,12 @@ static char scancode_to_char_shift[] = {
     '-', KEY_LEFT, '5', KEY_RIGHT, '+'
 };
 
-// Circular Buffer
-volatile KeyEvent event_buffer[RING_BUFFER_SIZE];
+// Circular Buffer, allocated by keyboard_init (a few entries stay static in
+// case the heap is not up)
+#define RING_FALLBACK_SIZE 8
+static KeyEvent ring_fallback[RING_FALLBACK_SIZE];
+volatile KeyEvent* event_buffer = ring_fallback;
+static int ring_size = RING_FALLBACK_SIZE;
 volatile int read_ptr = 0;
 volatile int write_ptr = 0;
 
@@ -118,7 +123,7 @@ void keyboard_handler(struct registers* regs) {
         
         // Valid key event?
         if (c != 0 && c != KEY_SHIFT && c != KEY_CTRL && c != KEY_ALT && c != KEY_CAPS) {
-            int next_write = (write_ptr + 1) % RING_BUFFER_SIZE;
+            int next_write = (write_ptr + 1) % ring_size;
             if (next_write != read_ptr) {
                 KeyEvent evt;
                 evt.character = c;
@@ -140,6 +145,12 @@ void keyboard_handler(struct registers* regs) {
 }
 
 void keyboard_init() {
+    // Runs before interrupts are enabled, so the handler never sees the swap
+    KeyEvent* ring = (KeyEvent*)kzalloc(RING_BUFFER_SIZE * sizeof(KeyEvent));
+    if (ring) {
+        event_buffer = ring;
+        ring_size = RING_BUFFER_SIZE;
+    }
     read_ptr = 0;
     write_ptr = 0;
     while (inb(KEYBOARD_PORT_STATUS) & 1) inb(KEYBOARD_PORT_DATA);
@@ -153,7 +164,7 @@ KeyEvent keyboard_get_event() {
     }
     
     KeyEvent evt = event_buffer[read_ptr];
-    read_ptr = (read_ptr + 1) % RING_BUFFER_SIZE;
+    read_ptr = (read_ptr + 1) % ring_size;
     return evt;
 }
 
@@ -3,6 +3,7 @@
 #include "util/io.h"
 #include "drivers/framebuffer.h"
 #include "cpu/timer.h"
+#include "mm/arena.h"
 
 #define RTL8139_VENDOR_ID 0x10EC
 #define RTL8139_DEVICE_ID 0x8139
@@ -213,9 +214,12 @@ int rtl8139_arp_ping(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3) {
     if (!rtl8139_send_packet(pkt, 64)) return 0;
 
     // Wait for ARP reply (up to 2 seconds = 200 ticks at 100Hz)
-    uint8_t reply[256];
+    struct ArenaScope scope = arena_scope_begin(&frame_arena);
+    uint8_t* reply = (uint8_t*)arena_alloc(&frame_arena, 256);
+    if (!reply) return 0;
+    int found = 0;
     uint64_t start = get_tick_count();
-    while ((get_tick_count() - start) < 200) {
+    while (!found && (get_tick_count() - start) < 200) {
         int len = rtl8139_check_rx(reply, 256);
         if (len >= 42) {
             // Check if this is an ARP reply
@@ -226,7 +230,8 @@ int rtl8139_arp_ping(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3) {
                     // Check sender IP matches our target
                     if (reply[28] == ip0 && reply[29] == ip1 &&
                         reply[30] == ip2 && reply[31] == ip3) {
-                        return 1; // Success! Got ARP reply
+                        found = 1; // Success! Got ARP reply
+                        break;
                     }
                 }
             }
@@ -235,5 +240,6 @@ int rtl8139_arp_ping(uint8_t ip0, uint8_t ip1, uint8_t ip2, uint8_t ip3) {
         asm volatile("hlt");
     }
 
-    return 0; // Timeout, no reply
+    arena_scope_end(&scope);
+    return found; // 0 = timeout, no reply
 }
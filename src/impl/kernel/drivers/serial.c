@@ -0,0 +1,47 @@
+#include "drivers/serial.h"
+#include "util/io.h"
+
+// COM1 boot log (QEMU: -serial stdio)
+#define COM1 0x3F8
+
+static int serial_ready = 0;
+
+void serial_init() {
+    outb(COM1 + 1, 0x00); // Disable interrupts
+    outb(COM1 + 3, 0x80); // Enable DLAB
+    outb(COM1 + 0, 0x01); // Divisor 1 = 115200 baud
+    outb(COM1 + 1, 0x00);
+    outb(COM1 + 3, 0x03); // 8N1
+    outb(COM1 + 2, 0xC7); // Enable & clear FIFO
+    outb(COM1 + 4, 0x03); // DTR + RTS
+
+    // No UART present reads back as 0xFF
+    serial_ready = (inb(COM1 + 5) != 0xFF);
+}
+
+void serial_write_char(char c) {
+    if (!serial_ready) return;
+    uint32_t timeout = 100000;
+    while (!(inb(COM1 + 5) & 0x20) && timeout--);
+    if (c == '\n') outb(COM1, '\r');
+    outb(COM1, c);
+}
+
+void serial_write_str(const char* str) {
+    while (*str) serial_write_char(*str++);
+}
+
+void serial_write_dec(uint64_t value) {
+    char tmp[21];
+    int i = 0;
+    if (value == 0) tmp[i++] = '0';
+    while (value > 0) { tmp[i++] = '0' + (value % 10); value /= 10; }
+    while (i > 0) serial_write_char(tmp[--i]);
+}
+
+void serial_write_hex(uint64_t value) {
+    serial_write_str("0x");
+    for (int shift = 60; shift >= 0; shift -= 4) {
+        serial_write_char("0123456789abcdef"[(value >> shift) & 0xF]);
+    }
+}
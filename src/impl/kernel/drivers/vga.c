@@ -1,8 +1,22 @@
 #include "drivers/vga.h"
+#include "util/io.h"
 
 const static size_t NUM_COLS = 80;
 const static size_t NUM_ROWS = 25;
 
+// Text memory (0xB8000-0xBFFFF) is used as a ring of RING_ROWS rows. The
+// screen shows NUM_ROWS of them starting at ring row `top`; scrolling moves
+// the CRTC start address instead of copying. Only when the window reaches
+// the end of the ring are the visible rows copied back to the start, once
+// every RING_ROWS - NUM_ROWS lines.
+#define TEXT_MEM_CELLS 16384
+#define RING_ROWS (TEXT_MEM_CELLS / 80)
+
+#define CRTC_INDEX 0x3D4
+#define CRTC_DATA  0x3D5
+#define CRTC_START_HIGH 0x0C
+#define CRTC_START_LOW  0x0D
+
 struct Char {
     uint8_t character;
     uint8_t color;
@@ -10,23 +24,44 @@ struct Char {
 
 struct Char* buffer = (struct Char*) 0xb8000;
 size_t col = 0;
-size_t row = 0;
+size_t row = 0; // screen row
 uint8_t color = 0x0F; // White on Black default
+static size_t top = 0; // ring row at the top of the screen
 
-void print_clear_row(size_t row) {
-    struct Char empty = (struct Char){
-        .character = ' ',
-        .color = color,
-    };
-    for (size_t col = 0; col < NUM_COLS; col++) {
-        buffer[col + NUM_COLS * row] = empty;
+static uint16_t* row_cells(size_t screen_row) {
+    return (uint16_t*)(buffer + (top + screen_row) * NUM_COLS);
+}
+
+static void set_start_address() {
+    uint16_t start = (uint16_t)(top * NUM_COLS);
+    outb(CRTC_INDEX, CRTC_START_HIGH);
+    outb(CRTC_DATA, start >> 8);
+    outb(CRTC_INDEX, CRTC_START_LOW);
+    outb(CRTC_DATA, start & 0xFF);
+}
+
+// Write n cells with 64-bit stores where the destination allows
+static void write_cells(uint16_t* dst, const uint16_t* src, size_t n) {
+    while (n && ((uintptr_t)dst & 7)) { *dst++ = *src++; n--; }
+    for (; n >= 4; n -= 4, dst += 4, src += 4) {
+        *(uint64_t*)dst = (uint64_t)src[0] | ((uint64_t)src[1] << 16) |
+                          ((uint64_t)src[2] << 32) | ((uint64_t)src[3] << 48);
     }
+    while (n--) *dst++ = *src++;
+}
+
+void print_clear_row(size_t row) {
+    uint16_t blank[80];
+    for (size_t col = 0; col < NUM_COLS; col++) blank[col] = ' ' | (color << 8);
+    write_cells(row_cells(row), blank, NUM_COLS);
 }
 
 void print_clear() {
+    top = 0;
     for (size_t i = 0; i < NUM_ROWS; i++) {
         print_clear_row(i);
     }
+    set_start_address();
     col = 0;
     row = 0;
 }
@@ -37,15 +72,19 @@ void print_newline() {
         row++;
         return;
     }
-    
+
     // Scroll
-    for (size_t row = 1; row < NUM_ROWS; row++) {
-        for (size_t col = 0; col < NUM_COLS; col++) {
-            struct Char character = buffer[col + NUM_COLS * row];
-            buffer[col + NUM_COLS * (row - 1)] = character;
+    if (top + NUM_ROWS == RING_ROWS) {
+        // End of the ring: bring the rows that stay visible back to the start
+        for (size_t r = 1; r < NUM_ROWS; r++) {
+            write_cells((uint16_t*)(buffer + (r - 1) * NUM_COLS), row_cells(r), NUM_COLS);
         }
+        top = 0;
+    } else {
+        top++;
     }
     print_clear_row(NUM_ROWS - 1);
+    set_start_address();
     row = NUM_ROWS - 1;
 }
 
@@ -54,24 +93,35 @@ void print_char(char character) {
         print_newline();
         return;
     }
-    
+
     if (col >= NUM_COLS) {
         print_newline();
     }
-    
-    buffer[col + NUM_COLS * row] = (struct Char){
-        .character = (uint8_t) character,
-        .color = color,
-    };
-    
+
+    row_cells(row)[col] = (uint8_t) character | (color << 8);
     col++;
 }
 
+// Characters up to the end of the row are gathered and written in one go
 void print_str(char* str) {
-    for (size_t i = 0; 1; i++) {
-        char character = (uint8_t) str[i];
-        if (character == '\0') return;
-        print_char(character);
+    size_t i = 0;
+    while (str[i] != '\0') {
+        if (str[i] == '\n') {
+            print_newline();
+            i++;
+            continue;
+        }
+        if (col >= NUM_COLS) {
+            print_newline();
+        }
+
+        uint16_t run[80];
+        size_t n = 0;
+        while (str[i] != '\0' && str[i] != '\n' && col + n < NUM_COLS) {
+            run[n++] = (uint8_t) str[i++] | (color << 8);
+        }
+        write_cells(row_cells(row) + col, run, n);
+        col += n;
     }
 }
 
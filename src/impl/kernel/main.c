@@ -3,6 +3,16 @@
 #include "drivers/mouse.h"
 #include "drivers/framebuffer.h"
 #include "cpu/idt.h"
+#include "cpu/pat.h"
+#include "cpu/simd.h"
+#include "drivers/display/span.h"
+#include "drivers/display/blend.h"
+#include "drivers/display/raster.h"
+#include "mm/pmm.h"
+#include "mm/heap.h"
+#include "mm/arena.h"
+#include "mm/vmm.h"
+#include "drivers/serial.h"
 #include "drivers/rtl8139.h"
 #include "drivers/audio/pc_speaker.h"
 #include "drivers/audio/hda.h"
@@ -18,14 +28,21 @@
 #include "cpu/timer.h" 
 #include "drivers/rtc.h"
 #include "ui/ui.h"
+#include "ui/display_list.h"
+#include "ui/surface.h"
+#include "ui/compositor.h"
+#include "ui/frame_scheduler.h"
+#include "ui/assets.h"
 
 // --- GUI STATE ---
 int current_app = APP_HOME;
 bool request_redraw = true;
 
 // --- NOTEPAD STATE ---
+// Text and clipboard are demand-zero regions (mm/vmm.h): only the pages the
+// user actually fills take RAM
 #define NOTE_BUF_SIZE 65536
-char notepad_buffer[NOTE_BUF_SIZE];
+char* notepad_buffer;
 int note_len = 0;           // total chars in buffer
 int note_pos = 0;           // cursor position (insertion point)
 int note_sel = -1;          // selection anchor (-1 = no selection)
@@ -34,7 +51,7 @@ int note_total_lines = 1;   // cached total line count
 int note_visible_lines = 1; // cached visible line count
 bool note_sb_dragging = false; // scrollbar thumb dragging
 int note_sb_drag_offset = 0;   // offset within thumb when drag started
-char note_clipboard[NOTE_BUF_SIZE];
+char* note_clipboard;
 int note_clip_len = 0;
 
 // Helper: get selection range (ordered)
@@ -114,6 +131,10 @@ int setting_word_wrap = 1;      // 0=off, 1=on
 int setting_line_numbers = 0;   // 0=off, 1=on
 int setting_tab_size = 4;       // 2 or 4
 
+// VRAM blit bandwidth measured at boot (MB/s), before/after write-combining
+uint32_t fb_bw_before = 0;
+uint32_t fb_bw_after = 0;
+
 // Timezone offsets (hours from UTC)
 static const int tz_offsets[] = { -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
 static const char* tz_labels[] = {
@@ -142,9 +163,33 @@ static uint32_t get_text(void)    { return themes[setting_theme][1]; }
 static uint32_t get_sidebar(void) { return themes[setting_theme][2]; }
 static uint32_t get_select(void)  { return themes[setting_theme][3]; }
 
-// Cursor dimensions must match framebuffer_draw_cursor
-#define CURSOR_W 12
-#define CURSOR_H 16
+// Retained display lists, one per view (sidebar and each app)
+#define SIDEBAR_DL_PRIMS  128
+#define HOME_DL_PRIMS     256
+#define HOME_DL_TEXT      1024
+#define NOTE_DL_PRIMS     24576
+#define NOTE_DL_TEXT      16384
+#define SETTINGS_DL_PRIMS 2048
+#define SETTINGS_DL_TEXT  8192
+#define APP_COUNT 3
+static struct DlPrim sidebar_dl_prims[2 * SIDEBAR_DL_PRIMS];
+static char sidebar_dl_text[2 * 256];
+static struct DlPrim home_dl_prims[2 * HOME_DL_PRIMS];
+static char home_dl_text[2 * HOME_DL_TEXT];
+static struct DlPrim note_dl_prims[2 * NOTE_DL_PRIMS];
+static char note_dl_text[2 * NOTE_DL_TEXT];
+static struct DlPrim settings_dl_prims[2 * SETTINGS_DL_PRIMS];
+static char settings_dl_text[2 * SETTINGS_DL_TEXT];
+static struct DisplayList sidebar_dl;
+static struct DisplayList app_dl[APP_COUNT];
+
+// Off-screen surfaces: inactive apps keep their pixels, so switching apps
+// is a compositor blit. All null if the surface arena is too small for
+// the mode (then views draw straight into the back buffer).
+static struct Surface* sidebar_surface = 0;
+static struct Surface* app_surface[APP_COUNT];
+static int drawn_app = -1; // app whose display list matches the screen (no surfaces)
+static int note_drawn_scroll = 0; // note_scroll_y of the Notepad frame on screen
 
 // --- HELPERS ---
 
@@ -153,7 +198,16 @@ void print_2digits(int val, int x, int y, int scale) {
     buf[0] = '0' + (val / 10);
     buf[1] = '0' + (val % 10);
     buf[2] = 0;
-    text_draw_string_scaled(buf, x, y, get_text(), get_bg(), scale);
+    dl_draw_string_scaled(buf, x, y, get_text(), get_bg(), scale);
+}
+
+// Write decimal digits of val into buf (no terminator), return length
+int format_uint(char* buf, uint32_t val) {
+    char tmp[10]; int ti = 0;
+    if (val == 0) tmp[ti++] = '0';
+    while (val > 0) { tmp[ti++] = '0' + (val % 10); val /= 10; }
+    for (int j = 0; j < ti; j++) buf[j] = tmp[ti - 1 - j];
+    return ti;
 }
 
 void print_4digits(int val, int x, int y, int scale) {
@@ -163,9 +217,46 @@ void print_4digits(int val, int x, int y, int scale) {
     buf[2] = '0' + ((val / 10) % 10);
     buf[3] = '0' + (val % 10);
     buf[4] = 0;
-    text_draw_string_scaled(buf, x, y, get_text(), get_bg(), scale);
+    dl_draw_string_scaled(buf, x, y, get_text(), get_bg(), scale);
 }
 
+// Notepad text-area geometry, shared by drawing and scrolling
+struct NoteLayout {
+    int line_num_w;       // line number gutter
+    int text_area_x;
+    int text_area_y;
+    int scrollbar_w;
+    int text_area_w;
+    int text_area_h;
+    int line_h;
+    int char_w;
+    int max_chars_per_line;
+    int visible_lines;
+};
+
+static struct NoteLayout note_layout(void) {
+    struct NoteLayout l;
+    l.line_num_w = setting_line_numbers ? 36 : 0;
+    l.text_area_x = SIDEBAR_WIDTH + 20 + l.line_num_w;
+    l.text_area_y = 60;
+    l.scrollbar_w = 12;
+    l.text_area_w = fb.width - l.text_area_x - 20 - l.scrollbar_w;
+    l.text_area_h = fb.height - l.text_area_y - 10;
+    l.line_h = 12;
+    l.char_w = 8;
+    l.max_chars_per_line = setting_word_wrap ? (l.text_area_w / l.char_w) : 10000;
+    if (l.max_chars_per_line < 1) l.max_chars_per_line = 1;
+    l.visible_lines = l.text_area_h / l.line_h;
+    return l;
+}
+
+// Clamp note_scroll_y so the cursor line is visible
+static void note_scroll_to_cursor(const struct NoteLayout* l) {
+    int cursor_line = note_pos_to_line(note_pos, l->max_chars_per_line);
+    if (cursor_line < note_scroll_y) note_scroll_y = cursor_line;
+    if (cursor_line >= note_scroll_y + l->visible_lines) note_scroll_y = cursor_line - l->visible_lines + 1;
+    if (note_scroll_y < 0) note_scroll_y = 0;
+}
 
 // Check click hits
 int get_clicked_app(int x, int y) {
@@ -183,72 +274,71 @@ void draw_sidebar() {
     uint32_t icon_col = get_text();
 
     // 1. Draw Sidebar Background
-    framebuffer_draw_rect(0, 0, SIDEBAR_WIDTH, fb.height, sb_col); 
+    dl_draw_rect(0, 0, SIDEBAR_WIDTH, fb.height, sb_col); 
     
     // 2. Draw Divider Line
-    framebuffer_draw_rect(SIDEBAR_WIDTH, 0, 2, fb.height, 0xFF999999);
+    dl_draw_rect(SIDEBAR_WIDTH, 0, 2, fb.height, 0xFF999999);
 
     // 3. Draw Selection Highlight
     if (current_app == APP_HOME) {
-        framebuffer_draw_rect(5, 50, 40, 40, sel_col);
+        dl_draw_rect(5, 50, 40, 40, sel_col);
     } else if (current_app == APP_NOTE) {
-        framebuffer_draw_rect(5, 100, 40, 40, sel_col);
+        dl_draw_rect(5, 100, 40, 40, sel_col);
     } else if (current_app == APP_SETTINGS) {
-        framebuffer_draw_rect(5, 150, 40, 40, sel_col);
+        dl_draw_rect(5, 150, 40, 40, sel_col);
     }
 
-    // 4. Draw "House" Icon (at y=50) 
-    // Roof
-    for(int i=0; i<20; i++) {
-         framebuffer_draw_rect(25-i, 50+10+i, i*2, 1, icon_col);
-    }
+    // 4. Draw "House" Icon (at y=50)
+    static const int roof[] = { 25, 60, 45, 80, 5, 80 };
+    dl_draw_polygon(roof, 3, icon_col, RASTER_AA);
     // Base
-    framebuffer_draw_rect(15, 70+5, 20, 15, icon_col);
+    dl_draw_rect(15, 70+5, 20, 15, icon_col);
     // Door
-    framebuffer_draw_rect(22, 75+5, 6, 10, sb_col); 
+    dl_draw_round_rect(22, 75+5, 6, 10, 2, sb_col, RASTER_AA);
 
     // 5. Draw "Note" Icon (at y=100)
-    framebuffer_draw_rect(15, 105, 20, 30, icon_col); // Paper shape
-    framebuffer_draw_rect(17, 107, 16, 26, get_bg());  // White content
+    dl_draw_round_rect(15, 105, 20, 30, 3, icon_col, RASTER_AA); // Paper shape
+    dl_draw_round_rect(17, 107, 16, 26, 2, get_bg(), RASTER_AA); // White content
     // Lines
-    framebuffer_draw_rect(19, 112, 12, 1, icon_col);
-    framebuffer_draw_rect(19, 116, 12, 1, icon_col);
-    framebuffer_draw_rect(19, 120, 12, 1, icon_col);
-
-    // 6. Draw "Gear" Icon (at y=150)
-    // Outer circle (approximate with rects)
-    framebuffer_draw_rect(20, 155, 10, 2, icon_col);  // top
-    framebuffer_draw_rect(20, 183, 10, 2, icon_col);  // bottom
-    framebuffer_draw_rect(12, 163, 2, 10, icon_col);  // left
-    framebuffer_draw_rect(36, 163, 2, 10, icon_col);  // right
-    // Diagonal teeth
-    framebuffer_draw_rect(14, 157, 3, 3, icon_col);   // top-left
-    framebuffer_draw_rect(33, 157, 3, 3, icon_col);   // top-right
-    framebuffer_draw_rect(14, 178, 3, 3, icon_col);   // bottom-left
-    framebuffer_draw_rect(33, 178, 3, 3, icon_col);   // bottom-right
-    // Center body
-    framebuffer_draw_rect(17, 160, 16, 18, icon_col);
-    framebuffer_draw_rect(15, 163, 20, 12, icon_col);
-    // Center hole
-    framebuffer_draw_rect(21, 165, 8, 8, sb_col);
+    dl_draw_line(19, 112, 30, 112, icon_col, 0);
+    dl_draw_line(19, 116, 30, 116, icon_col, 0);
+    dl_draw_line(19, 120, 30, 120, icon_col, 0);
+
+    // 6. Draw "Gear" Icon (centred on 25,169)
+    // Straight teeth
+    dl_draw_rect(22, 155, 7, 4, icon_col);   // top
+    dl_draw_rect(22, 180, 7, 4, icon_col);   // bottom
+    dl_draw_rect(11, 166, 4, 7, icon_col);   // left
+    dl_draw_rect(36, 166, 4, 7, icon_col);   // right
+    // Diagonal teeth (squares rotated 45 degrees)
+    static const int teeth[4][8] = {
+        { 29, 178, 34, 173, 38, 177, 33, 182 }, // bottom-right
+        { 22, 178, 17, 173, 13, 177, 18, 182 }, // bottom-left
+        { 29, 161, 34, 166, 38, 162, 33, 157 }, // top-right
+        { 22, 161, 17, 166, 13, 162, 18, 157 }, // top-left
+    };
+    for (int i = 0; i < 4; i++) dl_draw_polygon(teeth[i], 4, icon_col, RASTER_AA);
+    // Body and centre hole
+    dl_draw_circle(25, 169, 10, 0, icon_col, RASTER_AA);
+    dl_draw_circle(25, 169, 4, 0, sb_col, RASTER_AA);
 }
 
 // --- SETTINGS HELPERS ---
 void draw_toggle(int x, int y, int on) {
     // Toggle track (40x20)
     uint32_t track_col = on ? COL_TOGGLE_ON : COL_TOGGLE_OFF;
-    framebuffer_draw_rect(x, y, 40, 20, track_col);
+    dl_draw_rect(x, y, 40, 20, track_col);
     // Knob
     uint32_t knob_x = on ? x + 22 : x + 2;
-    framebuffer_draw_rect(knob_x, y + 2, 16, 16, 0xFFFFFFFF);
+    dl_draw_rect(knob_x, y + 2, 16, 16, 0xFFFFFFFF);
 }
 
 void draw_radio(int x, int y, int selected) {
     // Simple radio: filled square if selected, outline if not
-    framebuffer_draw_rect(x, y, 14, 14, get_text());
-    framebuffer_draw_rect(x + 2, y + 2, 10, 10, get_bg());
+    dl_draw_rect(x, y, 14, 14, get_text());
+    dl_draw_rect(x + 2, y + 2, 10, 10, get_bg());
     if (selected) {
-        framebuffer_draw_rect(x + 4, y + 4, 6, 6, COL_ACCENT);
+        dl_draw_rect(x + 4, y + 4, 6, 6, COL_ACCENT);
     }
 }
 
@@ -263,12 +353,12 @@ void draw_radio(int x, int y, int selected) {
 void draw_settings_tab(int x, int y, const char* label, int selected) {
     uint32_t bg = selected ? get_bg() : get_select();
     uint32_t fg = selected ? COL_ACCENT : get_text();
-    framebuffer_draw_rect(x, y, SETTINGS_TAB_WIDTH, SETTINGS_TAB_HEIGHT, bg);
+    dl_draw_rect(x, y, SETTINGS_TAB_WIDTH, SETTINGS_TAB_HEIGHT, bg);
     // Bottom highlight for selected tab
     if (selected) {
-        framebuffer_draw_rect(x, y + SETTINGS_TAB_HEIGHT - 3, SETTINGS_TAB_WIDTH, 3, COL_ACCENT);
+        dl_draw_rect(x, y + SETTINGS_TAB_HEIGHT - 3, SETTINGS_TAB_WIDTH, 3, COL_ACCENT);
     }
-    text_draw_string(label, x + 10, y + 9, fg, bg);
+    dl_draw_string(label, x + 10, y + 9, fg, bg);
 }
 
 void draw_settings_page() {
@@ -277,7 +367,7 @@ void draw_settings_page() {
     int cx = SIDEBAR_WIDTH + 20;
     int cy = 20;
 
-    text_draw_string_scaled("Settings", cx, cy, fg, bg, 3);
+    dl_draw_string_scaled("Settings", cx, cy, fg, bg, 3);
     cy += 38;
 
     // --- Category Tabs ---
@@ -294,54 +384,54 @@ void draw_settings_page() {
     cy += SETTINGS_TAB_HEIGHT;
 
     // Tab bar underline
-    framebuffer_draw_rect(cx, cy, fb.width - SIDEBAR_WIDTH - 40, 1, 0xFF999999);
+    dl_draw_rect(cx, cy, fb.width - SIDEBAR_WIDTH - 40, 1, 0xFF999999);
     cy += 15;
 
     // --- Category Content ---
     if (settings_category == SETTINGS_CAT_GENERAL) {
-        text_draw_string_scaled("Mouse", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Mouse", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("Mouse Speed", cx, cy + 3, fg, bg);
+        dl_draw_string("Mouse Speed", cx, cy + 3, fg, bg);
         // Speed selector: 3 radios
         static const char* speed_names[] = { "Slow", "Normal", "Fast" };
         for (int i = 0; i < 3; i++) {
             int rx = cx + 150 + i * 75;
             draw_radio(rx, cy + 2, setting_mouse_speed == i);
-            text_draw_string(speed_names[i], rx + 18, cy + 3, fg, bg);
+            dl_draw_string(speed_names[i], rx + 18, cy + 3, fg, bg);
         }
         cy += 32;
 
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 15;
 
-        text_draw_string_scaled("Editor", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Editor", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("Cursor blink", cx, cy + 3, fg, bg);
+        dl_draw_string("Cursor blink", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_cursor_blink);
         cy += 32;
 
-        text_draw_string("Word wrap", cx, cy + 3, fg, bg);
+        dl_draw_string("Word wrap", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_word_wrap);
         cy += 32;
 
-        text_draw_string("Line numbers", cx, cy + 3, fg, bg);
+        dl_draw_string("Line numbers", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_line_numbers);
         cy += 32;
 
-        text_draw_string("Tab size", cx, cy + 3, fg, bg);
+        dl_draw_string("Tab size", cx, cy + 3, fg, bg);
         // Tab size selector: 2-space or 4-space
         int rx2 = cx + 150;
         draw_radio(rx2, cy + 2, setting_tab_size == 2);
-        text_draw_string("2", rx2 + 18, cy + 3, fg, bg);
+        dl_draw_string("2", rx2 + 18, cy + 3, fg, bg);
         rx2 += 50;
         draw_radio(rx2, cy + 2, setting_tab_size == 4);
-        text_draw_string("4", rx2 + 18, cy + 3, fg, bg);
+        dl_draw_string("4", rx2 + 18, cy + 3, fg, bg);
         cy += 32;
 
     } else if (settings_category == SETTINGS_CAT_APPEARANCE) {
-        text_draw_string_scaled("Theme", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Theme", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
         // Draw theme radios in 2 rows of 3
@@ -351,77 +441,77 @@ void draw_settings_page() {
             int rx = cx + col * 90;
             int ry = cy + row * 24;
             draw_radio(rx, ry + 2, setting_theme == i);
-            text_draw_string(theme_names[i], rx + 20, ry + 3, fg, bg);
+            dl_draw_string(theme_names[i], rx + 20, ry + 3, fg, bg);
         }
         cy += 24 * 2 + 10;
 
         // Theme preview box
-        text_draw_string("Preview:", cx, cy, 0xFF888888, bg);
+        dl_draw_string("Preview:", cx, cy, 0xFF888888, bg);
         cy += 14;
         uint32_t prev_bg = themes[setting_theme][0];
         uint32_t prev_fg = themes[setting_theme][1];
         uint32_t prev_sb = themes[setting_theme][2];
-        framebuffer_draw_rect(cx, cy, 200, 50, prev_sb);
-        framebuffer_draw_rect(cx + 30, cy, 170, 50, prev_bg);
-        text_draw_string("Abc", cx + 50, cy + 20, prev_fg, prev_bg);
-        framebuffer_draw_rect(cx, cy, 200, 1, 0xFF999999);
-        framebuffer_draw_rect(cx, cy + 49, 200, 1, 0xFF999999);
-        framebuffer_draw_rect(cx, cy, 1, 50, 0xFF999999);
-        framebuffer_draw_rect(cx + 199, cy, 1, 50, 0xFF999999);
+        dl_draw_rect(cx, cy, 200, 50, prev_sb);
+        dl_draw_rect(cx + 30, cy, 170, 50, prev_bg);
+        dl_draw_string("Abc", cx + 50, cy + 20, prev_fg, prev_bg);
+        dl_draw_rect(cx, cy, 200, 1, 0xFF999999);
+        dl_draw_rect(cx, cy + 49, 200, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 1, 50, 0xFF999999);
+        dl_draw_rect(cx + 199, cy, 1, 50, 0xFF999999);
 
     } else if (settings_category == SETTINGS_CAT_CLOCK) {
-        text_draw_string_scaled("Time Format", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Time Format", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("24-hour format", cx, cy + 3, fg, bg);
+        dl_draw_string("24-hour format", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_clock_24h);
         cy += 32;
 
-        text_draw_string("Show seconds", cx, cy + 3, fg, bg);
+        dl_draw_string("Show seconds", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_show_seconds);
         cy += 40;
 
         // Divider
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 15;
 
-        text_draw_string_scaled("Date", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Date", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("Show date on home", cx, cy + 3, fg, bg);
+        dl_draw_string("Show date on home", cx, cy + 3, fg, bg);
         draw_toggle(cx + 200, cy, setting_show_date);
         cy += 40;
 
         // Divider
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 15;
 
-        text_draw_string_scaled("Time Zone", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Time Zone", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
         // Timezone selector: show current with < > arrows
         // Left arrow
-        framebuffer_draw_rect(cx, cy, 20, 20, get_select());
-        text_draw_string("<", cx + 6, cy + 5, fg, get_select());
+        dl_draw_rect(cx, cy, 20, 20, get_select());
+        dl_draw_string("<", cx + 6, cy + 5, fg, get_select());
         // Current timezone label
-        framebuffer_draw_rect(cx + 24, cy, 80, 20, get_select());
-        text_draw_string(tz_labels[setting_timezone], cx + 30, cy + 5, fg, get_select());
+        dl_draw_rect(cx + 24, cy, 80, 20, get_select());
+        dl_draw_string(tz_labels[setting_timezone], cx + 30, cy + 5, fg, get_select());
         // Right arrow
-        framebuffer_draw_rect(cx + 108, cy, 20, 20, get_select());
-        text_draw_string(">", cx + 114, cy + 5, fg, get_select());
+        dl_draw_rect(cx + 108, cy, 20, 20, get_select());
+        dl_draw_string(">", cx + 114, cy + 5, fg, get_select());
         cy += 30;
 
     } else if (settings_category == SETTINGS_CAT_NETWORK) {
-        text_draw_string_scaled("Network", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Network", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
         // Network adapter status
         int net_found = rtl8139_is_detected();
-        text_draw_string("Adapter:", cx, cy, fg, bg);
+        dl_draw_string("Adapter:", cx, cy, fg, bg);
         if (net_found) {
-            text_draw_string("RTL8139 (Detected)", cx + 80, cy, COL_TOGGLE_ON, bg);
+            dl_draw_string("RTL8139 (Detected)", cx + 80, cy, COL_TOGGLE_ON, bg);
         } else {
-            text_draw_string("Not detected", cx + 80, cy, 0xFFCC0000, bg);
+            dl_draw_string("Not detected", cx + 80, cy, 0xFFCC0000, bg);
         }
         cy += 16;
 
@@ -436,73 +526,73 @@ void draw_settings_page() {
                 mac_str[i*3+2] = (i < 5) ? ':' : '\0';
             }
             mac_str[17] = '\0';
-            text_draw_string("MAC:", cx, cy, fg, bg);
-            text_draw_string(mac_str, cx + 80, cy, fg, bg);
+            dl_draw_string("MAC:", cx, cy, fg, bg);
+            dl_draw_string(mac_str, cx + 80, cy, fg, bg);
             cy += 16;
 
-            text_draw_string("Status:", cx, cy, fg, bg);
-            text_draw_string("Link Up (Emulated)", cx + 80, cy, COL_TOGGLE_ON, bg);
+            dl_draw_string("Status:", cx, cy, fg, bg);
+            dl_draw_string("Link Up (Emulated)", cx + 80, cy, COL_TOGGLE_ON, bg);
         } else {
-            text_draw_string("Status:", cx, cy, fg, bg);
-            text_draw_string("No link", cx + 80, cy, 0xFFCC0000, bg);
+            dl_draw_string("Status:", cx, cy, fg, bg);
+            dl_draw_string("No link", cx + 80, cy, 0xFFCC0000, bg);
         }
         cy += 24;
 
         // Divider
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 15;
 
         // Network test button
-        text_draw_string_scaled("Network Test", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("Network Test", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("Sends ARP request to 10.0.2.2 (gateway)", cx, cy, 0xFF888888, bg);
+        dl_draw_string("Sends ARP request to 10.0.2.2 (gateway)", cx, cy, 0xFF888888, bg);
         cy += 16;
 
         // "Run Test" button
         uint32_t btn_col = COL_ACCENT;
-        framebuffer_draw_rect(cx, cy, 140, 26, btn_col);
-        text_draw_string("ARP Ping Test", cx + 12, cy + 8, 0xFFFFFFFF, btn_col);
+        dl_draw_rect(cx, cy, 140, 26, btn_col);
+        dl_draw_string("ARP Ping Test", cx + 12, cy + 8, 0xFFFFFFFF, btn_col);
 
         // Test result
         cy += 30;
         if (net_test_running == 1) {
-            text_draw_string("Sending ARP request...", cx, cy, 0xFFAAAA00, bg);
+            dl_draw_string("Sending ARP request...", cx, cy, 0xFFAAAA00, bg);
         } else if (net_test_running == 2) {
-            text_draw_string("PASS - ARP reply received from gateway!", cx, cy, COL_TOGGLE_ON, bg);
+            dl_draw_string("PASS - ARP reply received from gateway!", cx, cy, COL_TOGGLE_ON, bg);
             cy += 14;
-            text_draw_string("Network connectivity confirmed.", cx, cy, COL_TOGGLE_ON, bg);
+            dl_draw_string("Network connectivity confirmed.", cx, cy, COL_TOGGLE_ON, bg);
         } else if (net_test_running == 3) {
-            text_draw_string("FAIL - No ARP reply (timeout 2s)", cx, cy, 0xFFCC0000, bg);
+            dl_draw_string("FAIL - No ARP reply (timeout 2s)", cx, cy, 0xFFCC0000, bg);
             cy += 14;
-            text_draw_string("Check network adapter & link.", cx, cy, 0xFFCC0000, bg);
+            dl_draw_string("Check network adapter & link.", cx, cy, 0xFFCC0000, bg);
         } else if (net_test_running == 4) {
-            text_draw_string("FAIL - Could not transmit packet", cx, cy, 0xFFCC0000, bg);
+            dl_draw_string("FAIL - Could not transmit packet", cx, cy, 0xFFCC0000, bg);
         }
         cy += 36;
 
     } else if (settings_category == SETTINGS_CAT_ABOUT) {
-        text_draw_string_scaled("SynCanvas", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("SynCanvas", cx, cy, COL_ACCENT, bg, 2);
         cy += 28;
 
-        text_draw_string("The innovation in operating systems,", cx, cy, fg, bg); cy += 12;
-        text_draw_string("no windows, just one canvas, where", cx, cy, fg, bg); cy += 12;
-        text_draw_string("everything is possible!", cx, cy, fg, bg); cy += 16;
-        text_draw_string("By: Raketapingvin", cx, cy, COL_ACCENT, bg); cy += 20;
+        dl_draw_string("The innovation in operating systems,", cx, cy, fg, bg); cy += 12;
+        dl_draw_string("no windows, just one canvas, where", cx, cy, fg, bg); cy += 12;
+        dl_draw_string("everything is possible!", cx, cy, fg, bg); cy += 16;
+        dl_draw_string("By: Raketapingvin", cx, cy, COL_ACCENT, bg); cy += 20;
 
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 12;
 
-        text_draw_string("Version: 1.2.0 - (builds on github)", cx, cy, fg, bg); cy += 20;
+        dl_draw_string("Version: 1.2.0 - (builds on github)", cx, cy, fg, bg); cy += 20;
 
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 12;
 
-        text_draw_string_scaled("System Info", cx, cy, COL_ACCENT, bg, 2);
+        dl_draw_string_scaled("System Info", cx, cy, COL_ACCENT, bg, 2);
         cy += 24;
 
-        text_draw_string("Platform:    x86_64", cx, cy, fg, bg); cy += 12;
-        text_draw_string("Kernel:      Monolithic", cx, cy, fg, bg); cy += 12;
+        dl_draw_string("Platform:    x86_64", cx, cy, fg, bg); cy += 12;
+        dl_draw_string("Kernel:      Monolithic", cx, cy, fg, bg); cy += 12;
 
         // Display resolution
         char res_buf[40];
@@ -532,22 +622,61 @@ void draw_settings_page() {
             for (int j = ti - 1; j >= 0; j--) res_buf[ri++] = tmp[j];
         }
         res_buf[ri] = '\0';
-        text_draw_string("Display:     ", cx, cy, fg, bg);
-        text_draw_string(res_buf, cx + 104, cy, fg, bg); cy += 12;
-
-        text_draw_string("Timer:       PIT @ 100Hz", cx, cy, fg, bg); cy += 12;
-        text_draw_string("RTC:         CMOS Real-Time Clock", cx, cy, fg, bg); cy += 16;
-
-        framebuffer_draw_rect(cx, cy, 300, 1, 0xFF999999);
+        dl_draw_string("Display:     ", cx, cy, fg, bg);
+        dl_draw_string(res_buf, cx + 104, cy, fg, bg); cy += 12;
+
+        // Boot-time blit bandwidth: "UC -> WC MB/s"
+        char bw_buf[40];
+        int bi = format_uint(bw_buf, fb_bw_before);
+        bw_buf[bi++] = ' '; bw_buf[bi++] = '-'; bw_buf[bi++] = '>'; bw_buf[bi++] = ' ';
+        bi += format_uint(bw_buf + bi, fb_bw_after);
+        bw_buf[bi++] = ' '; bw_buf[bi++] = 'M'; bw_buf[bi++] = 'B'; bw_buf[bi++] = '/'; bw_buf[bi++] = 's';
+        bw_buf[bi] = '\0';
+        dl_draw_string("VRAM blit:   ", cx, cy, fg, bg);
+        dl_draw_string(bw_buf, cx + 104, cy, fg, bg); cy += 12;
+
+        // Frame scheduler: "frames, dropped, avg/max render time"
+        struct FrameStats fs = frame_scheduler_get_stats();
+        char fr_buf[72];
+        int fi = format_uint(fr_buf, (uint32_t)fs.frames);
+        const char* fr_drop = " frames, ";
+        for (int k = 0; fr_drop[k]; k++) fr_buf[fi++] = fr_drop[k];
+        fi += format_uint(fr_buf + fi, (uint32_t)fs.dropped);
+        const char* fr_avg = " dropped, ";
+        for (int k = 0; fr_avg[k]; k++) fr_buf[fi++] = fr_avg[k];
+        fi += format_uint(fr_buf + fi, fs.avg_us);
+        fr_buf[fi++] = '/';
+        fi += format_uint(fr_buf + fi, fs.max_us);
+        fr_buf[fi++] = ' '; fr_buf[fi++] = 'u'; fr_buf[fi++] = 's';
+        fr_buf[fi] = '\0';
+        dl_draw_string("Frames:      ", cx, cy, fg, bg);
+        dl_draw_string(fr_buf, cx + 104, cy, fg, bg); cy += 12;
+
+        // Physical memory: "free / usable MiB"
+        struct PmmStats ps = pmm_get_stats();
+        char mem_buf[40];
+        int mi = format_uint(mem_buf, (uint32_t)(ps.free_pages / 256));
+        mem_buf[mi++] = ' '; mem_buf[mi++] = '/'; mem_buf[mi++] = ' ';
+        mi += format_uint(mem_buf + mi, (uint32_t)(ps.total_pages / 256));
+        const char* mem_unit = " MiB free";
+        for (int k = 0; mem_unit[k]; k++) mem_buf[mi++] = mem_unit[k];
+        mem_buf[mi] = '\0';
+        dl_draw_string("Memory:      ", cx, cy, fg, bg);
+        dl_draw_string(mem_buf, cx + 104, cy, fg, bg); cy += 12;
+
+        dl_draw_string("Timer:       PIT @ 100Hz, UI @ 60Hz", cx, cy, fg, bg); cy += 12;
+        dl_draw_string("RTC:         CMOS Real-Time Clock", cx, cy, fg, bg); cy += 16;
+
+        dl_draw_rect(cx, cy, 300, 1, 0xFF999999);
         cy += 12;
 
-        text_draw_string("Drivers:", cx, cy, fg, bg); cy += 14;
-        text_draw_string("  PS/2 Keyboard & Mouse", cx, cy, 0xFF888888, bg); cy += 12;
-        text_draw_string("  VGA / Framebuffer display", cx, cy, 0xFF888888, bg); cy += 12;
-        text_draw_string("  ATA / AHCI / NVMe storage", cx, cy, 0xFF888888, bg); cy += 12;
-        text_draw_string("  RTL8139 network", cx, cy, 0xFF888888, bg); cy += 12;
-        text_draw_string("  USB (UHCI/xHCI)", cx, cy, 0xFF888888, bg); cy += 12;
-        text_draw_string("  AC97 / HDA / PC Speaker audio", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("Drivers:", cx, cy, fg, bg); cy += 14;
+        dl_draw_string("  PS/2 Keyboard & Mouse", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("  VGA / Framebuffer display", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("  ATA / AHCI / NVMe storage", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("  RTL8139 network", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("  USB (UHCI/xHCI)", cx, cy, 0xFF888888, bg); cy += 12;
+        dl_draw_string("  AC97 / HDA / PC Speaker audio", cx, cy, 0xFF888888, bg); cy += 12;
     }
 }
 
@@ -703,15 +832,19 @@ int handle_settings_click(int mx, int my) {
     return 0;
 }
 
-void draw_content() {
+void draw_content(int app) {
     uint32_t bg = get_bg();
     uint32_t fg = get_text();
 
     // Clear Content Area
-    framebuffer_draw_rect(SIDEBAR_WIDTH + 2, 0, fb.width - SIDEBAR_WIDTH - 2, fb.height, bg);
+    dl_draw_rect(SIDEBAR_WIDTH + 2, 0, fb.width - SIDEBAR_WIDTH - 2, fb.height, bg);
 
-    if (current_app == APP_HOME) {
-        text_draw_string_scaled("Welcome to SynCanvas", SIDEBAR_WIDTH + 20, 50, fg, bg, 2);
+    if (app == APP_HOME) {
+        dl_draw_string_scaled("Welcome to SynCanvas", SIDEBAR_WIDTH + 20, 50, fg, bg, 2);
+        const struct UiImage* logo = assets_logo();
+        if (logo->width) {
+            dl_draw_image(logo->pixels, fb.width - 20 - logo->width, 20, logo->width, logo->height);
+        }
         
         Time t = rtc_get_time();
         int base_y = 90;
@@ -733,80 +866,75 @@ void draw_content() {
             if (display_hours == 0) display_hours = 12;
         }
 
-        text_draw_string_scaled("Time: ", SIDEBAR_WIDTH + 20, base_y, fg, bg, scale);
+        dl_draw_string_scaled("Time: ", SIDEBAR_WIDTH + 20, base_y, fg, bg, scale);
         int x_off = SIDEBAR_WIDTH + 20 + (6 * char_w);
         print_2digits(display_hours, x_off, base_y, scale);
         
         x_off += (2 * char_w);
-        text_draw_string_scaled(":", x_off, base_y, fg, bg, scale);
+        dl_draw_string_scaled(":", x_off, base_y, fg, bg, scale);
         
         x_off += char_w;
         print_2digits(t.minutes, x_off, base_y, scale);
 
         if (setting_show_seconds) {
             x_off += (2 * char_w);
-            text_draw_string_scaled(":", x_off, base_y, fg, bg, scale);
+            dl_draw_string_scaled(":", x_off, base_y, fg, bg, scale);
             x_off += char_w;
             print_2digits(t.seconds, x_off, base_y, scale);
         }
 
         if (!setting_clock_24h) {
             x_off += (2 * char_w) + char_w / 2;
-            text_draw_string_scaled(is_pm ? "PM" : "AM", x_off, base_y, fg, bg, scale);
+            dl_draw_string_scaled(is_pm ? "PM" : "AM", x_off, base_y, fg, bg, scale);
         }
 
         if (setting_show_date) {
             base_y += (10 * scale); // New line
-            text_draw_string_scaled("Date: ", SIDEBAR_WIDTH + 20, base_y, fg, bg, scale);
+            dl_draw_string_scaled("Date: ", SIDEBAR_WIDTH + 20, base_y, fg, bg, scale);
             
             x_off = SIDEBAR_WIDTH + 20 + (6 * char_w);
             print_2digits(t.day, x_off, base_y, scale);
             
             x_off += (2 * char_w);
-            text_draw_string_scaled("/", x_off, base_y, fg, bg, scale);
+            dl_draw_string_scaled("/", x_off, base_y, fg, bg, scale);
             
             x_off += char_w;
             print_2digits(t.month, x_off, base_y, scale);
             
             x_off += (2 * char_w);
-            text_draw_string_scaled("/", x_off, base_y, fg, bg, scale);
+            dl_draw_string_scaled("/", x_off, base_y, fg, bg, scale);
             
             x_off += char_w;
             print_4digits(2000 + t.year, x_off, base_y, scale);
         }
 
-    } else if (current_app == APP_SETTINGS) {
+    } else if (app == APP_SETTINGS) {
         draw_settings_page();
 
-    } else if (current_app == APP_NOTE) {
-        int line_num_w = setting_line_numbers ? 36 : 0; // width for line number gutter
-        int text_area_x = SIDEBAR_WIDTH + 20 + line_num_w;
-        int text_area_y = 60;
-        int scrollbar_w = 12;
-        int text_area_w = fb.width - text_area_x - 20 - scrollbar_w;
-        int text_area_h = fb.height - text_area_y - 10;
-        int line_h = 12;
-        int char_w = 8;
-        int max_chars_per_line = setting_word_wrap ? (text_area_w / char_w) : 10000;
-        if (max_chars_per_line < 1) max_chars_per_line = 1;
-        int visible_lines = text_area_h / line_h;
-
-        text_draw_string("Notepad", SIDEBAR_WIDTH + 20, 20, fg, bg);
+    } else if (app == APP_NOTE) {
+        struct NoteLayout lay = note_layout();
+        int line_num_w = lay.line_num_w;
+        int text_area_x = lay.text_area_x;
+        int text_area_y = lay.text_area_y;
+        int scrollbar_w = lay.scrollbar_w;
+        int text_area_h = lay.text_area_h;
+        int line_h = lay.line_h;
+        int char_w = lay.char_w;
+        int max_chars_per_line = lay.max_chars_per_line;
+        int visible_lines = lay.visible_lines;
+
+        dl_draw_string("Notepad", SIDEBAR_WIDTH + 20, 20, fg, bg);
         // Show char count
-        {
-            char count_buf[32] = "Chars: ";
-            int ci = 7;
-            int n = note_len;
-            if (n == 0) { count_buf[ci++] = '0'; }
-            else {
-                char tmp[8]; int ti = 0;
-                while (n > 0) { tmp[ti++] = '0' + (n % 10); n /= 10; }
-                for (int j = ti - 1; j >= 0; j--) count_buf[ci++] = tmp[j];
-            }
+        char* count_buf = (char*)arena_alloc(&frame_arena, 32);
+        if (count_buf) {
+            const char* label = "Chars: ";
+            int ci = 0;
+            for (; label[ci]; ci++) count_buf[ci] = label[ci];
+            ci += format_uint(count_buf + ci, (uint32_t)note_len);
             count_buf[ci] = '\0';
-            text_draw_string(count_buf, SIDEBAR_WIDTH + 20, 40, 0xFFAAAAAA, bg);
+            dl_draw_string(count_buf, SIDEBAR_WIDTH + 20, 40, 0xFFAAAAAA, bg);
         }
-        text_draw_string("Ctrl+A/C/X/V | Arrows | Ctrl+Arrows", SIDEBAR_WIDTH + 200, 40, 0xFFAAAAAA, bg);
+        dl_draw_string("Ctrl+A/C/X/V | Arrows | Ctrl+Arrows", SIDEBAR_WIDTH + 200, 40, 0xFFAAAAAA, bg);
 
         // Count total lines
         int total_lines = 1;
@@ -820,10 +948,7 @@ void draw_content() {
         note_visible_lines = visible_lines;
 
         // Ensure cursor line is visible (auto-scroll)
-        int cursor_line = note_pos_to_line(note_pos, max_chars_per_line);
-        if (cursor_line < note_scroll_y) note_scroll_y = cursor_line;
-        if (cursor_line >= note_scroll_y + visible_lines) note_scroll_y = cursor_line - visible_lines + 1;
-        if (note_scroll_y < 0) note_scroll_y = 0;
+        note_scroll_to_cursor(&lay);
 
         // Get selection range
         int sel_start, sel_end;
@@ -838,22 +963,22 @@ void draw_content() {
 
         // Line number gutter background
         if (setting_line_numbers) {
-            framebuffer_draw_rect(SIDEBAR_WIDTH + 18, text_area_y, line_num_w, text_area_h, get_select());
+            dl_draw_rect(SIDEBAR_WIDTH + 18, text_area_y, line_num_w, text_area_h, get_select());
         }
 
         // Draw text with selection highlighting and line numbers
         int draw_line = 0;
         int draw_col = 0;
         int last_drawn_line = -1;
+        char* lnbuf = (char*)arena_alloc(&frame_arena, 8);
         for (int i = 0; i <= note_len; i++) {
             int screen_line = draw_line - note_scroll_y;
             if (screen_line >= visible_lines) break;
 
             // Draw line number
-            if (setting_line_numbers && screen_line >= 0 && draw_line != last_drawn_line) {
+            if (setting_line_numbers && lnbuf && screen_line >= 0 && draw_line != last_drawn_line) {
                 last_drawn_line = draw_line;
                 int ln = draw_line + 1;
-                char lnbuf[6];
                 int li = 0;
                 if (ln >= 1000) lnbuf[li++] = '0' + (ln / 1000) % 10;
                 if (ln >= 100)  lnbuf[li++] = '0' + (ln / 100) % 10;
@@ -861,14 +986,14 @@ void draw_content() {
                 lnbuf[li++] = '0' + ln % 10;
                 lnbuf[li] = '\0';
                 int lx = SIDEBAR_WIDTH + 20 + (line_num_w - 4 - li * 8);
-                text_draw_string(lnbuf, lx, text_area_y + screen_line * line_h + 2, 0xFF888888, get_select());
+                dl_draw_string(lnbuf, lx, text_area_y + screen_line * line_h + 2, 0xFF888888, get_select());
             }
 
             // Draw cursor at this position
             if (i == note_pos && screen_line >= 0 && cursor_visible) {
                 int cx = text_area_x + draw_col * char_w;
                 int cy2 = text_area_y + screen_line * line_h;
-                framebuffer_draw_rect(cx, cy2, 2, line_h - 2, fg);
+                dl_draw_rect(cx, cy2, 2, line_h - 2, fg);
             }
 
             if (i >= note_len) break;
@@ -879,12 +1004,12 @@ void draw_content() {
 
                 // Selection background
                 if (note_sel >= 0 && i >= sel_start && i < sel_end) {
-                    framebuffer_draw_rect(cx, cy2, char_w, line_h, COL_ACCENT);
+                    dl_draw_rect(cx, cy2, char_w, line_h, COL_ACCENT);
                     if (notepad_buffer[i] != '\n')
-                        text_draw_char(notepad_buffer[i], cx, cy2 + 2, 0xFFFFFFFF, COL_ACCENT);
+                        dl_draw_char(notepad_buffer[i], cx, cy2 + 2, 0xFFFFFFFF, COL_ACCENT);
                 } else {
                     if (notepad_buffer[i] != '\n')
-                        text_draw_char(notepad_buffer[i], cx, cy2 + 2, fg, bg);
+                        dl_draw_char(notepad_buffer[i], cx, cy2 + 2, fg, bg);
                 }
             }
 
@@ -903,24 +1028,104 @@ void draw_content() {
             int sb_h = text_area_h;
 
             // Track
-            framebuffer_draw_rect(sb_x, sb_y, scrollbar_w, sb_h, get_select());
+            dl_draw_rect(sb_x, sb_y, scrollbar_w, sb_h, get_select());
 
             // Thumb
             int thumb_h = (visible_lines * sb_h) / total_lines;
             if (thumb_h < 16) thumb_h = 16;
             int thumb_y = sb_y + (note_scroll_y * (sb_h - thumb_h)) / (total_lines - visible_lines);
-            framebuffer_draw_rect(sb_x + 2, thumb_y, scrollbar_w - 4, thumb_h, COL_ACCENT);
+            dl_draw_rect(sb_x + 2, thumb_y, scrollbar_w - 4, thumb_h, COL_ACCENT);
         }
     }
 }
 
+// Create the sidebar and per-app surfaces; on failure everything draws
+// straight into the back buffer as before
+static void create_surfaces(void) {
+    uint32_t content_x = SIDEBAR_WIDTH + 2;
+    sidebar_surface = surface_create(0, 0, content_x, fb.height);
+    for (int app = 0; app < APP_COUNT; app++) {
+        app_surface[app] = surface_create(content_x, 0, fb.width - content_x, fb.height);
+    }
+
+    if (!sidebar_surface || !app_surface[APP_HOME] || !app_surface[APP_NOTE] || !app_surface[APP_SETTINGS]) {
+        surface_destroy(sidebar_surface);
+        sidebar_surface = 0;
+        for (int app = 0; app < APP_COUNT; app++) {
+            surface_destroy(app_surface[app]);
+            app_surface[app] = 0;
+        }
+        serial_write_str("ui: surface arena too small, drawing without compositor\n");
+        return;
+    }
+
+    compositor_set_background(COL_BG);
+    for (int app = 0; app < APP_COUNT; app++) compositor_add(app_surface[app]);
+    compositor_add(sidebar_surface);
+}
+
+// Re-record the sidebar and the current app. Each app's display list only
+// rasterizes what changed since that app was last on screen.
+static void render_views(void) {
+    surface_bind(sidebar_surface);
+    display_list_begin(&sidebar_dl);
+    draw_sidebar();
+    display_list_end(&sidebar_dl);
+
+    struct DisplayList* dl = &app_dl[current_app];
+    if (!sidebar_surface && drawn_app != current_app) {
+        // Shared back buffer: the screen holds another app's pixels
+        display_list_invalidate(dl);
+    }
+    surface_bind(app_surface[current_app]);
+
+    if (current_app == APP_NOTE) {
+        // Scroll the text already on screen with one bulk move so only the
+        // lines that scroll in are rasterized
+        struct NoteLayout lay = note_layout();
+        note_scroll_to_cursor(&lay);
+        int lines = note_scroll_y - note_drawn_scroll;
+        if (lines != 0) {
+            int x0 = SIDEBAR_WIDTH + 18; // includes the line number gutter
+            display_list_scroll(dl, x0, lay.text_area_y, lay.text_area_x + lay.text_area_w - x0,
+                                lay.visible_lines * lay.line_h, -lines * lay.line_h);
+        }
+    }
+
+    display_list_begin(dl);
+    draw_content(current_app);
+    display_list_end(dl);
+    surface_bind(0);
+    drawn_app = current_app;
+    if (current_app == APP_NOTE) note_drawn_scroll = note_scroll_y;
+
+    if (sidebar_surface) {
+        compositor_raise(app_surface[current_app]);
+        compositor_compose();
+    }
+}
+
 void kernel_main(unsigned long addr) {
     // Stage 1: Init Core
+    simd_init();
+    span_init();
+    blend_init();
     idt_init();
     timer_init(100);
+    serial_init();
     
     // Stage 2: Graphics
     framebuffer_init((void*)addr);
+    pmm_init((void*)addr);
+    kmem_init();
+    assets_init();
+    vmm_init();
+    // The boot page tables stop at 4 GiB; map VRAM placed above that
+    if ((uint64_t)fb.base_address + fb.buffer_size * 2 > 0x100000000ull) {
+        vmm_map_device((uint64_t)fb.base_address, fb.buffer_size * 2, VMM_CACHE_UC_MINUS);
+    }
+    notepad_buffer = (char*)vmm_reserve(NOTE_BUF_SIZE);
+    note_clipboard = (char*)vmm_reserve(NOTE_BUF_SIZE);
     framebuffer_clear(COL_BG); // White Background
 
     // Stage 3: Drivers
@@ -928,6 +1133,7 @@ void kernel_main(unsigned long addr) {
     keyboard_init();
     
     // Init others silently (to ensure detection works if we query later)
+    graphics_init();
     ata_init(); ahci_init(); nvme_init();
     usbus_init(); xhci_init();
     rtl8139_init(); 
@@ -941,25 +1147,51 @@ void kernel_main(unsigned long addr) {
     // Now that interrupts are enabled, activate mouse IRQ handler
     mouse_enable_irq();
 
-    // Initial GUI Draw
-    draw_sidebar();
-    draw_content();
-
-    // Mouse Logic
-    struct MouseState last_mouse = {0,0,0,0,0};
-    uint32_t cursor_backing_store[12*16]; 
-    
-    // Initial Bg Save
-    struct MouseState temp = mouse_get_state();
-    last_mouse = temp;
-    for(int y=0; y<16; y++) {
-        for(int x=0; x<12; x++) {
-            cursor_backing_store[y*12 + x] = framebuffer_get_pixel(last_mouse.x + x, last_mouse.y + y);
-        }
+    // Remap VRAM as write-combining via PAT and log blit bandwidth before/after
+    fb_bw_before = framebuffer_measure_bandwidth();
+    int fb_pages = framebuffer_enable_page_flip() ? 2 : 1;
+    if (pat_init()) {
+        pat_map_write_combining((uint64_t)fb.base_address, fb.buffer_size * fb_pages);
     }
-    framebuffer_draw_cursor(last_mouse.x, last_mouse.y);
+    fb_bw_after = framebuffer_measure_bandwidth();
+    serial_write_str("fb: blit bandwidth ");
+    serial_write_dec(fb_bw_before);
+    serial_write_str(" MB/s (uncached) -> ");
+    serial_write_dec(fb_bw_after);
+    serial_write_str(" MB/s (write-combining, ");
+    serial_write_str(span_backend_name());
+    serial_write_str(" spans)\n");
+    serial_write_str(fb_pages == 2 ? "fb: BGA page flipping enabled\n" : "fb: single buffered VRAM\n");
+    struct PmmStats pmm = pmm_get_stats();
+    serial_write_str("mm: ");
+    serial_write_dec(pmm.free_pages / 256);
+    serial_write_str(" MiB free of ");
+    serial_write_dec(pmm.total_pages / 256);
+    serial_write_str(" MiB usable (");
+    serial_write_dec(pmm.reserved_pages / 256);
+    serial_write_str(" MiB kernel/boot reserved)\n");
+    serial_write_str("mm: kernel heap with ");
+    serial_write_dec(kmem_cache_count());
+    serial_write_str(" size classes (16..");
+    serial_write_dec(KMEM_MAX_OBJECT);
+    serial_write_str(" bytes)\n");
+
+    // Initial GUI Draw
+    display_list_init(&sidebar_dl, sidebar_dl_prims, SIDEBAR_DL_PRIMS, sidebar_dl_text, 256);
+    display_list_init(&app_dl[APP_HOME], home_dl_prims, HOME_DL_PRIMS, home_dl_text, HOME_DL_TEXT);
+    display_list_init(&app_dl[APP_NOTE], note_dl_prims, NOTE_DL_PRIMS, note_dl_text, NOTE_DL_TEXT);
+    display_list_init(&app_dl[APP_SETTINGS], settings_dl_prims, SETTINGS_DL_PRIMS, settings_dl_text, SETTINGS_DL_TEXT);
+    create_surfaces();
+    render_views();
+
+    // Mouse Logic: the cursor is an overlay composited during the flush
+    struct MouseState last_mouse = mouse_get_state();
+    framebuffer_set_cursor(last_mouse.x, last_mouse.y, 1);
+    framebuffer_swap();
 
     request_redraw = true;
+    bool views_dirty = false;
+    frame_scheduler_init(60);
     uint64_t last_clock_tick = get_tick_count();
 
     while (1) {
@@ -1310,39 +1542,36 @@ void kernel_main(unsigned long addr) {
              }
         }
         
-        // Unified Redraw Logic
+        // Unified Redraw Logic: input is handled on every wakeup, changes
+        // accumulate and are rendered at most once per refresh slot
         bool mouse_moved = (current.x != last_mouse.x || current.y != last_mouse.y);
-        
-        if (screen_dirty || request_redraw || mouse_moved) {
-            // 1. Hide Cursor (restore background at OLD position)
-            for(int y=0; y<16; y++) {
-                for(int x=0; x<12; x++) {
-                     framebuffer_put_pixel(last_mouse.x + x, last_mouse.y + y, cursor_backing_store[y*12 + x]);
-                }
-            }
+        last_mouse = current;
 
-            // 2. Update Content (if needed)
-            if (screen_dirty || request_redraw) {
-                draw_sidebar();
-                draw_content();  // Always redraw content fully for stability
-                request_redraw = false;
-            }
+        if (screen_dirty || request_redraw) {
+            views_dirty = true;
+            request_redraw = false;
+            frame_request();
+        }
+        if (mouse_moved) frame_request();
 
-            // 3. Update Mouse Position Logic
-            if (mouse_moved) {
-                last_mouse = current;
-            }
+        if (frame_due()) {
+            frame_begin();
 
-            // 4. Save New Background at (potentially new) Mouse Position
-            // optimization: only read from framebuffer, do not use get_pixel potentially if we had a backbuffer
-            for(int y=0; y<16; y++) {
-                for(int x=0; x<12; x++) {
-                    cursor_backing_store[y*12 + x] = framebuffer_get_pixel(last_mouse.x + x, last_mouse.y + y);
-                }
+            // 1. Update Content (if needed): views are re-recorded in full,
+            // but only primitives that differ from the last frame are rasterized
+            // into their surfaces, then composited
+            if (views_dirty) {
+                render_views();
+                views_dirty = false;
             }
-            
-            // 5. Draw Cursor at (potentially new) Position
-            framebuffer_draw_cursor(last_mouse.x, last_mouse.y);
+
+            // 2. Move the cursor overlay (damages only its old and new rects)
+            framebuffer_set_cursor(current.x, current.y, 1);
+
+            // 3. Flush this frame's damaged tiles to VRAM
+            framebuffer_swap();
+            frame_end();
+            arena_reset(&frame_arena);
         }
         
         asm volatile("hlt");
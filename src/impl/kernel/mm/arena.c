@@ -0,0 +1,51 @@
+#include "mm/arena.h"
+
+static uint8_t frame_arena_mem[FRAME_ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+struct Arena frame_arena = { frame_arena_mem, FRAME_ARENA_SIZE, 0, 0 };
+
+void arena_init(struct Arena* a, void* mem, size_t size) {
+    // Round the base up so every allocation is aligned
+    uint64_t base = ((uint64_t)mem + ARENA_ALIGN - 1) & ~(uint64_t)(ARENA_ALIGN - 1);
+    size_t skip = base - (uint64_t)mem;
+    a->base = (uint8_t*)base;
+    a->size = size > skip ? size - skip : 0;
+    a->used = 0;
+    a->peak = 0;
+}
+
+void* arena_alloc(struct Arena* a, size_t size) {
+    size_t n = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size == 0 || n > a->size - a->used) return 0;
+    void* p = a->base + a->used;
+    a->used += n;
+    if (a->used > a->peak) a->peak = a->used;
+    return p;
+}
+
+void* arena_zalloc(struct Arena* a, size_t size) {
+    uint64_t* p = (uint64_t*)arena_alloc(a, size);
+    if (!p) return 0;
+    for (size_t i = 0; i < (size + 7) / 8; i++) p[i] = 0;
+    return p;
+}
+
+size_t arena_mark(const struct Arena* a) {
+    return a->used;
+}
+
+void arena_reset_to(struct Arena* a, size_t mark) {
+    if (mark < a->used) a->used = mark;
+}
+
+void arena_reset(struct Arena* a) {
+    a->used = 0;
+}
+
+struct ArenaScope arena_scope_begin(struct Arena* a) {
+    struct ArenaScope s = { a, a->used };
+    return s;
+}
+
+void arena_scope_end(struct ArenaScope* scope) {
+    arena_reset_to(scope->arena, scope->mark);
+}
@@ -0,0 +1,287 @@
+#include "mm/heap.h"
+#include "mm/pmm.h"
+
+// A slab is one page: this header, then equal objects. Free objects in a
+// slab are linked through their first bytes.
+#define SLAB_MAGIC  0x534C4142u // "SLAB"
+#define LARGE_MAGIC 0x4C524745u // "LRGE"
+#define SLAB_HEADER 64
+#define MIN_OBJECT  16
+
+struct Slab {
+    uint32_t magic;
+    uint32_t inuse;
+    uint32_t total;
+    uint32_t reserved;
+    struct KmemCache* cache;
+    void* free;
+    struct Slab* next;
+    struct Slab* prev;
+};
+
+// Header in front of a kmalloc() allocation that took whole pages
+struct Large {
+    uint32_t magic;
+    uint32_t order;
+    uint64_t reserved;
+};
+
+// Objects a CPU can hand out or take back without the cache lock
+struct Magazine {
+    uint32_t count;
+    void* objs[KMEM_MAGAZINE];
+    // Counted per CPU so the fast path writes no shared cache line
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t hits;
+} __attribute__((aligned(64)));
+
+struct KmemCache {
+    struct Magazine mag[KMEM_MAX_CPUS];
+    const char* name;
+    uint32_t size;
+    uint32_t per_slab;
+    volatile uint8_t lock;
+    // Slabs with some objects free, with none free, and at most one spare
+    struct Slab* partial;
+    struct Slab* full;
+    struct Slab* empty;
+    uint64_t slabs;
+};
+
+static struct KmemCache caches[KMEM_MAX_CACHES];
+static uint32_t cache_count = 0;
+static volatile uint8_t table_lock = 0;
+static uint64_t large_pages = 0;
+
+// kmalloc-16 .. kmalloc-KMEM_MAX_OBJECT, indexed by log2(size) - 4
+#define SIZE_CLASSES 7
+static struct KmemCache* size_caches[SIZE_CLASSES];
+static const char* size_names[SIZE_CLASSES] = {
+    "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+    "kmalloc-256", "kmalloc-512", "kmalloc-1024"
+};
+
+static inline void lock(volatile uint8_t* l) {
+    while (__atomic_test_and_set(l, __ATOMIC_ACQUIRE)) {
+        while (*l) __asm__ volatile("pause");
+    }
+}
+
+static inline void unlock(volatile uint8_t* l) {
+    __atomic_clear(l, __ATOMIC_RELEASE);
+}
+
+// Only the boot CPU runs kernel code so far (no APs are started); once they
+// are, this becomes a read of the per-CPU block
+static inline uint32_t this_cpu(void) {
+    return 0;
+}
+
+static void slab_link(struct Slab** list, struct Slab* s) {
+    s->prev = 0;
+    s->next = *list;
+    if (s->next) s->next->prev = s;
+    *list = s;
+}
+
+static void slab_unlink(struct Slab** list, struct Slab* s) {
+    if (s->prev) s->prev->next = s->next;
+    else *list = s->next;
+    if (s->next) s->next->prev = s->prev;
+}
+
+// Cache lock held. 0 when out of memory.
+static struct Slab* slab_new(struct KmemCache* c) {
+    uint64_t page = pmm_alloc(0);
+    if (!page) return 0;
+    struct Slab* s = (struct Slab*)page;
+    s->magic = SLAB_MAGIC;
+    s->inuse = 0;
+    s->total = c->per_slab;
+    s->cache = c;
+    s->free = 0;
+    // Link back to front so objects come out in address order
+    uint8_t* base = (uint8_t*)page + SLAB_HEADER;
+    for (uint32_t i = c->per_slab; i-- > 0;) {
+        void** obj = (void**)(base + i * c->size);
+        *obj = s->free;
+        s->free = obj;
+    }
+    c->slabs++;
+    return s;
+}
+
+// Move up to n objects from the slabs into out[]; cache lock held
+static uint32_t slab_take(struct KmemCache* c, void** out, uint32_t n) {
+    uint32_t got = 0;
+    while (got < n) {
+        struct Slab* s = c->partial;
+        if (!s) {
+            s = c->empty;
+            if (s) c->empty = 0;
+            else if (!(s = slab_new(c))) break;
+            slab_link(&c->partial, s);
+        }
+        while (got < n && s->free) {
+            void** obj = (void**)s->free;
+            s->free = *obj;
+            s->inuse++;
+            out[got++] = obj;
+        }
+        if (!s->free) {
+            slab_unlink(&c->partial, s);
+            slab_link(&c->full, s);
+        }
+    }
+    return got;
+}
+
+// Return an object to its slab; cache lock held
+static void slab_put(struct KmemCache* c, void* obj) {
+    struct Slab* s = (struct Slab*)((uint64_t)obj & ~(uint64_t)(PMM_PAGE_SIZE - 1));
+    if (!s->free) {
+        slab_unlink(&c->full, s);
+        slab_link(&c->partial, s);
+    }
+    *(void**)obj = s->free;
+    s->free = obj;
+    if (--s->inuse == 0) {
+        slab_unlink(&c->partial, s);
+        // Keep one empty slab against alloc/free churn at a slab boundary
+        if (c->empty) {
+            pmm_free((uint64_t)c->empty, 0);
+            c->slabs--;
+        }
+        c->empty = s;
+    }
+}
+
+struct KmemCache* kmem_cache_create(const char* name, uint32_t size) {
+    if (size == 0 || size > KMEM_MAX_OBJECT) return 0;
+    lock(&table_lock);
+    if (cache_count == KMEM_MAX_CACHES) {
+        unlock(&table_lock);
+        return 0;
+    }
+    struct KmemCache* c = &caches[cache_count++];
+    unlock(&table_lock);
+
+    if (size < MIN_OBJECT) size = MIN_OBJECT;
+    c->name = name;
+    c->size = (size + MIN_OBJECT - 1) & ~(uint32_t)(MIN_OBJECT - 1);
+    c->per_slab = (PMM_PAGE_SIZE - SLAB_HEADER) / c->size;
+    return c;
+}
+
+void* kmem_cache_alloc(struct KmemCache* c) {
+    struct Magazine* m = &c->mag[this_cpu()];
+    m->allocs++;
+    if (m->count) {
+        m->hits++;
+        return m->objs[--m->count];
+    }
+    // Refill half the magazine so a following free still fits
+    lock(&c->lock);
+    m->count = slab_take(c, m->objs, KMEM_MAGAZINE / 2);
+    unlock(&c->lock);
+    if (!m->count) {
+        m->allocs--;
+        return 0;
+    }
+    return m->objs[--m->count];
+}
+
+void kmem_cache_free(struct KmemCache* c, void* obj) {
+    if (!obj) return;
+    struct Magazine* m = &c->mag[this_cpu()];
+    m->frees++;
+    if (m->count < KMEM_MAGAZINE) {
+        m->hits++;
+        m->objs[m->count++] = obj;
+        return;
+    }
+    // Drain the older half back to the slabs
+    lock(&c->lock);
+    for (uint32_t i = 0; i < KMEM_MAGAZINE / 2; i++) slab_put(c, m->objs[i]);
+    unlock(&c->lock);
+    for (uint32_t i = KMEM_MAGAZINE / 2; i < KMEM_MAGAZINE; i++) {
+        m->objs[i - KMEM_MAGAZINE / 2] = m->objs[i];
+    }
+    m->count = KMEM_MAGAZINE / 2;
+    m->objs[m->count++] = obj;
+}
+
+void kmem_init(void) {
+    for (uint32_t i = 0; i < SIZE_CLASSES; i++) {
+        size_caches[i] = kmem_cache_create(size_names[i], MIN_OBJECT << i);
+    }
+}
+
+void* kmalloc(size_t size) {
+    if (size == 0) return 0;
+    if (size <= KMEM_MAX_OBJECT) {
+        uint32_t k = 0;
+        while (((size_t)MIN_OBJECT << k) < size) k++;
+        return kmem_cache_alloc(size_caches[k]);
+    }
+    uint32_t order = pmm_order_for(size + sizeof(struct Large));
+    if (order > PMM_MAX_ORDER) return 0;
+    uint64_t block = pmm_alloc(order);
+    if (!block) return 0;
+    struct Large* l = (struct Large*)block;
+    l->magic = LARGE_MAGIC;
+    l->order = order;
+    __atomic_fetch_add(&large_pages, 1u << order, __ATOMIC_RELAXED);
+    return l + 1;
+}
+
+void* kzalloc(size_t size) {
+    uint64_t* p = (uint64_t*)kmalloc(size);
+    if (!p) return 0;
+    // Every allocation is a multiple of 16 bytes
+    for (size_t i = 0; i < (size + 7) / 8; i++) p[i] = 0;
+    return p;
+}
+
+void kfree(void* ptr) {
+    if (!ptr) return;
+    // Slab objects and large blocks both start within their first page
+    uint64_t page = (uint64_t)ptr & ~(uint64_t)(PMM_PAGE_SIZE - 1);
+    uint32_t magic = *(uint32_t*)page;
+    if (magic == SLAB_MAGIC) {
+        kmem_cache_free(((struct Slab*)page)->cache, ptr);
+    } else if (magic == LARGE_MAGIC) {
+        struct Large* l = (struct Large*)page;
+        uint32_t order = l->order;
+        l->magic = 0;
+        __atomic_fetch_sub(&large_pages, 1u << order, __ATOMIC_RELAXED);
+        pmm_free(page, order);
+    }
+}
+
+uint32_t kmem_cache_count(void) {
+    return cache_count;
+}
+
+const char* kmem_cache_name(uint32_t index) {
+    return index < cache_count ? caches[index].name : 0;
+}
+
+struct KmemStats kmem_cache_get_stats(uint32_t index) {
+    struct KmemStats st = {0};
+    if (index >= cache_count) return st;
+    struct KmemCache* c = &caches[index];
+    for (uint32_t i = 0; i < KMEM_MAX_CPUS; i++) {
+        st.allocs += c->mag[i].allocs;
+        st.frees += c->mag[i].frees;
+        st.magazine_hits += c->mag[i].hits;
+    }
+    st.slabs = c->slabs;
+    st.objects_in_use = st.allocs - st.frees;
+    return st;
+}
+
+uint64_t kmem_large_pages(void) {
+    return large_pages;
+}
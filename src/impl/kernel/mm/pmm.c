@@ -0,0 +1,181 @@
+#include "mm/pmm.h"
+#include "drivers/framebuffer.h"
+
+// Linker script symbols bracketing the loaded image
+extern char _kernel_start[];
+extern char _kernel_end[];
+
+#define PMM_LIMIT   0x100000000ull // identity-mapped by the boot page tables
+#define PMM_PAGES   (PMM_LIMIT / PMM_PAGE_SIZE)
+#define LOW_MEMORY  0x100000ull    // BIOS data, option ROMs, future AP trampoline
+
+struct multiboot_tag {
+    uint32_t type;
+    uint32_t size;
+};
+
+#define MULTIBOOT_TAG_END  0
+#define MULTIBOOT_TAG_MMAP 6
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+struct multiboot_tag_mmap {
+    struct multiboot_tag common;
+    uint32_t entry_size;
+    uint32_t entry_version;
+};
+
+struct multiboot_mmap_entry {
+    uint64_t addr;
+    uint64_t len;
+    uint32_t type;
+    uint32_t reserved;
+};
+
+// Free blocks are linked through their first bytes
+struct FreeBlock {
+    struct FreeBlock* next;
+    struct FreeBlock* prev;
+};
+
+static struct FreeBlock* free_lists[PMM_MAX_ORDER + 1];
+
+// Per page: PAGE_FREE | order on the first page of a free block, 0 otherwise
+#define PAGE_FREE 0x80
+static uint8_t page_state[PMM_PAGES];
+
+static struct PmmStats stats = {0};
+
+static void list_push(uint64_t addr, uint32_t order) {
+    struct FreeBlock* b = (struct FreeBlock*)addr;
+    b->prev = 0;
+    b->next = free_lists[order];
+    if (b->next) b->next->prev = b;
+    free_lists[order] = b;
+    page_state[addr / PMM_PAGE_SIZE] = PAGE_FREE | order;
+    stats.free_blocks[order]++;
+}
+
+static void list_remove(uint64_t addr, uint32_t order) {
+    struct FreeBlock* b = (struct FreeBlock*)addr;
+    if (b->prev) b->prev->next = b->next;
+    else free_lists[order] = b->next;
+    if (b->next) b->next->prev = b->prev;
+    page_state[addr / PMM_PAGE_SIZE] = 0;
+    stats.free_blocks[order]--;
+}
+
+// Hand [start, end) to the allocator as the largest aligned blocks that fit
+static void add_free_range(uint64_t start, uint64_t end) {
+    while (start < end) {
+        uint32_t order = PMM_MAX_ORDER;
+        while (order > 0 && ((start & ((PMM_PAGE_SIZE << order) - 1)) ||
+                             start + (PMM_PAGE_SIZE << order) > end)) {
+            order--;
+        }
+        list_push(start, order);
+        start += PMM_PAGE_SIZE << order;
+        stats.total_pages += 1u << order;
+        stats.free_pages += 1u << order;
+    }
+}
+
+struct Range {
+    uint64_t start;
+    uint64_t end;
+};
+
+#define MAX_RESERVED 4
+static struct Range reserved[MAX_RESERVED];
+static int reserved_count = 0;
+
+static void reserve(uint64_t start, uint64_t len) {
+    if (reserved_count == MAX_RESERVED || len == 0) return;
+    reserved[reserved_count].start = start & ~(uint64_t)(PMM_PAGE_SIZE - 1);
+    reserved[reserved_count].end = (start + len + PMM_PAGE_SIZE - 1) & ~(uint64_t)(PMM_PAGE_SIZE - 1);
+    reserved_count++;
+}
+
+// Add an available region minus the reserved ranges from index i on
+static void add_region(uint64_t start, uint64_t end, int i) {
+    for (; i < reserved_count; i++) {
+        const struct Range* r = &reserved[i];
+        if (r->start < end && r->end > start) {
+            if (start < r->start) add_region(start, r->start, i + 1);
+            if (r->end < end) add_region(r->end, end, i + 1);
+            uint64_t s = start > r->start ? start : r->start;
+            uint64_t e = end < r->end ? end : r->end;
+            stats.reserved_pages += (e - s) / PMM_PAGE_SIZE;
+            return;
+        }
+    }
+    if (start < end) add_free_range(start, end);
+}
+
+void pmm_init(void* multiboot_info) {
+    uint32_t* mbi = (uint32_t*)multiboot_info;
+    reserve(0, LOW_MEMORY);
+    reserve((uint64_t)_kernel_start, (uint64_t)(_kernel_end - _kernel_start));
+    reserve((uint64_t)mbi, mbi[0]); // total_size
+    if (fb.base_address) reserve((uint64_t)fb.base_address, fb.buffer_size * 2); // both flip pages
+
+    // Skip total_size and reserved
+    struct multiboot_tag* tag = (struct multiboot_tag*)(mbi + 2);
+    while (tag->type != MULTIBOOT_TAG_END) {
+        if (tag->type == MULTIBOOT_TAG_MMAP) {
+            struct multiboot_tag_mmap* mmap = (struct multiboot_tag_mmap*)tag;
+            uint8_t* entry = (uint8_t*)(mmap + 1);
+            uint8_t* end = (uint8_t*)tag + tag->size;
+            for (; entry + sizeof(struct multiboot_mmap_entry) <= end; entry += mmap->entry_size) {
+                struct multiboot_mmap_entry* e = (struct multiboot_mmap_entry*)entry;
+                if (e->type != MULTIBOOT_MEMORY_AVAILABLE) continue;
+                uint64_t start = (e->addr + PMM_PAGE_SIZE - 1) & ~(uint64_t)(PMM_PAGE_SIZE - 1);
+                uint64_t stop = (e->addr + e->len) & ~(uint64_t)(PMM_PAGE_SIZE - 1);
+                if (stop > PMM_LIMIT) stop = PMM_LIMIT;
+                if (start < stop) add_region(start, stop, 0);
+            }
+        }
+        // Next tag (8-byte aligned)
+        tag = (struct multiboot_tag*)((uint8_t*)tag + ((tag->size + 7) & ~7));
+    }
+}
+
+uint64_t pmm_alloc(uint32_t order) {
+    if (order > PMM_MAX_ORDER) return 0;
+    uint32_t k = order;
+    while (k <= PMM_MAX_ORDER && !free_lists[k]) k++;
+    if (k > PMM_MAX_ORDER) return 0;
+
+    uint64_t addr = (uint64_t)free_lists[k];
+    list_remove(addr, k);
+    // Split, returning the upper halves
+    while (k > order) {
+        k--;
+        list_push(addr + (PMM_PAGE_SIZE << k), k);
+    }
+    stats.free_pages -= 1u << order;
+    return addr;
+}
+
+void pmm_free(uint64_t addr, uint32_t order) {
+    if (addr == 0 || addr >= PMM_LIMIT || order > PMM_MAX_ORDER) return;
+    stats.free_pages += 1u << order;
+    // Merge with the buddy while it is a free block of the same order
+    while (order < PMM_MAX_ORDER) {
+        uint64_t buddy = addr ^ (PMM_PAGE_SIZE << order);
+        if (buddy >= PMM_LIMIT || page_state[buddy / PMM_PAGE_SIZE] != (PAGE_FREE | order)) break;
+        list_remove(buddy, order);
+        if (buddy < addr) addr = buddy;
+        order++;
+    }
+    list_push(addr, order);
+}
+
+uint32_t pmm_order_for(size_t bytes) {
+    uint32_t order = 0;
+    while (order <= PMM_MAX_ORDER && ((size_t)PMM_PAGE_SIZE << order) < bytes) order++;
+    return order;
+}
+
+struct PmmStats pmm_get_stats(void) {
+    return stats;
+}
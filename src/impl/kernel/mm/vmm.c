@@ -0,0 +1,262 @@
+#include "mm/vmm.h"
+#include "mm/pmm.h"
+#include "cpu/cpu.h"
+
+// Linker script symbols: the boot page tables live in the kernel's .bss
+extern char _kernel_start[];
+extern char _kernel_end[];
+
+// Page table entry bits
+#define PTE_PRESENT  (1ull << 0)
+#define PTE_WRITE    (1ull << 1)
+#define PTE_PWT      (1ull << 3)
+#define PTE_PCD      (1ull << 4)
+#define PTE_HUGE     (1ull << 7)  // PS on PDPT/PD entries
+#define PTE_PAT_4K   (1ull << 7)  // PAT on 4 KiB entries
+#define PTE_PAT_HUGE (1ull << 12) // PAT on 2 MiB/1 GiB entries
+#define PTE_NX       (1ull << 63)
+#define PTE_FLAGS    0x1FFull     // P RW US PWT PCD A D PS G
+#define PTE_ADDR_MASK 0x000FFFFFFFFFF000ull
+
+// Levels: 0 = PT (4 KiB entries) .. 3 = PML4 (512 GiB entries)
+#define LEVEL_SHIFT(l) (12 + 9 * (l))
+#define LEVEL_SIZE(l)  (1ull << LEVEL_SHIFT(l))
+#define LEVEL_INDEX(v, l) (((v) >> LEVEL_SHIFT(l)) & 511)
+
+enum { OP_MAP, OP_UNMAP, OP_CACHE };
+
+static uint64_t* pml4 = 0;
+static int gigabyte_pages = 0;
+// Set when a table was freed: its cached translations need a full flush
+static int flush_all = 0;
+
+static inline uint64_t* table_of(uint64_t entry) {
+    return (uint64_t*)(entry & PTE_ADDR_MASK);
+}
+
+static inline uint64_t cache_bits(uint32_t cache) {
+    return ((cache & 1) ? PTE_PWT : 0) | ((cache & 2) ? PTE_PCD : 0);
+}
+
+static uint64_t new_table(void) {
+    uint64_t t = pmm_alloc(0);
+    if (!t) return 0;
+    uint64_t* p = (uint64_t*)t;
+    for (int i = 0; i < 512; i++) p[i] = 0;
+    return t;
+}
+
+// Free a page table and the tables below it; the boot tables are not ours
+static void free_table(uint64_t* table, int level) {
+    if (level > 0) {
+        for (int i = 0; i < 512; i++) {
+            if ((table[i] & PTE_PRESENT) && !(table[i] & PTE_HUGE)) free_table(table_of(table[i]), level - 1);
+        }
+    }
+    if ((char*)table >= _kernel_start && (char*)table < _kernel_end) return;
+    pmm_free((uint64_t)table, 0);
+    flush_all = 1;
+}
+
+// Replace a huge page at level with a table of 512 next-size pages that map
+// the same memory with the same attributes. 0 when out of memory.
+static int split(uint64_t* entry, int level) {
+    uint64_t t = pmm_alloc(0);
+    if (!t) return 0;
+    uint64_t* sub = (uint64_t*)t;
+    uint64_t base = *entry & PTE_ADDR_MASK & ~(LEVEL_SIZE(level) - 1);
+    uint64_t attrs = *entry & (PTE_FLAGS | PTE_NX);
+    if (level == 1) {
+        attrs &= ~PTE_HUGE;
+        if (*entry & PTE_PAT_HUGE) attrs |= PTE_PAT_4K;
+    } else {
+        attrs |= *entry & PTE_PAT_HUGE;
+    }
+    for (uint64_t i = 0; i < 512; i++) sub[i] = (base + i * LEVEL_SIZE(level - 1)) | attrs;
+    *entry = t | PTE_PRESENT | PTE_WRITE;
+    return 1;
+}
+
+// Apply op to [virt, end) within table. leaf carries the entry bits for
+// OP_MAP (without address and PS) and the cache bits for OP_CACHE.
+static int update(uint64_t* table, int level, uint64_t virt, uint64_t end,
+                  uint64_t phys, int op, uint64_t leaf) {
+    uint64_t size = LEVEL_SIZE(level);
+    while (virt < end) {
+        uint64_t* entry = &table[LEVEL_INDEX(virt, level)];
+        uint64_t next = (virt & ~(size - 1)) + size;
+        uint64_t stop = next < end ? next : end;
+        int whole = (virt & (size - 1)) == 0 && stop == next;
+        int present = (*entry & PTE_PRESENT) != 0;
+        int huge = level == 0 || (*entry & PTE_HUGE);
+
+        // Handle the whole entry here, or descend to the next level
+        int here = level == 0 || (level < 3 && whole);
+        if (op == OP_MAP && level > 0) {
+            here = here && (phys & (size - 1)) == 0 && (level == 1 || gigabyte_pages);
+        } else if (op == OP_CACHE) {
+            here = here && huge;
+        }
+
+        if (here) {
+            if (present && !huge) free_table(table_of(*entry), level - 1);
+            if (op == OP_MAP) {
+                *entry = phys | leaf | (level > 0 ? PTE_HUGE : 0);
+            } else if (op == OP_UNMAP) {
+                *entry = 0;
+            } else if (present) {
+                uint64_t pat = level > 0 ? PTE_PAT_HUGE : PTE_PAT_4K;
+                *entry = (*entry & ~(PTE_PWT | PTE_PCD | pat)) | leaf;
+            }
+            if (present) invlpg(virt);
+        } else if (present || op == OP_MAP) {
+            if (!present) {
+                uint64_t t = new_table();
+                if (!t) return 0;
+                *entry = t | PTE_PRESENT | PTE_WRITE;
+            } else if (huge) {
+                if (!split(entry, level)) return 0;
+                invlpg(virt);
+            }
+            if (!update(table_of(*entry), level - 1, virt, stop, phys, op, leaf)) return 0;
+        }
+        phys += stop - virt;
+        virt = stop;
+        if (virt == 0) break; // wrapped past the top of the address space
+    }
+    return 1;
+}
+
+static int run(uint64_t virt, uint64_t size, uint64_t phys, int op, uint64_t leaf) {
+    if (!pml4 || size == 0 || ((virt | phys | size) & (VMM_PAGE_SIZE - 1))) return 0;
+    flush_all = 0;
+    int ok = update(pml4, 3, virt, virt + size, phys, op, leaf);
+    if (flush_all) write_cr3(read_cr3());
+    return ok;
+}
+
+void vmm_init(void) {
+    pml4 = (uint64_t*)(read_cr3() & PTE_ADDR_MASK);
+
+    // 1 GiB pages: CPUID 0x80000001 EDX bit 26
+    uint32_t max_ext, edx;
+    cpuid(0x80000000, 0, &max_ext, 0, 0, 0);
+    if (max_ext >= 0x80000001) {
+        cpuid(0x80000001, 0, 0, 0, 0, &edx);
+        gigabyte_pages = (edx >> 26) & 1;
+    }
+}
+
+int vmm_has_1g_pages(void) {
+    return gigabyte_pages;
+}
+
+int vmm_map(uint64_t virt, uint64_t phys, uint64_t size, uint32_t flags) {
+    uint64_t leaf = PTE_PRESENT | cache_bits(flags & 3) | ((flags & VMM_WRITE) ? PTE_WRITE : 0);
+    return run(virt, size, phys, OP_MAP, leaf);
+}
+
+int vmm_unmap(uint64_t virt, uint64_t size) {
+    return run(virt, size, 0, OP_UNMAP, 0);
+}
+
+int vmm_set_cache(uint64_t virt, uint64_t size, uint32_t cache) {
+    return run(virt, size, 0, OP_CACHE, cache_bits(cache & 3));
+}
+
+void* vmm_map_device(uint64_t phys, uint64_t size, uint32_t cache) {
+    uint64_t start = phys & ~(VMM_PAGE_SIZE - 1);
+    uint64_t end = (phys + size + VMM_PAGE_SIZE - 1) & ~(VMM_PAGE_SIZE - 1);
+    if (!vmm_map(start, start, end - start, (cache & 3) | VMM_WRITE)) return 0;
+    return (void*)phys;
+}
+
+uint64_t vmm_translate(uint64_t virt) {
+    if (!pml4) return 0;
+    uint64_t* table = pml4;
+    for (int level = 3; level >= 0; level--) {
+        uint64_t e = table[LEVEL_INDEX(virt, level)];
+        if (!(e & PTE_PRESENT)) return 0;
+        if (level == 0 || (e & PTE_HUGE)) {
+            uint64_t size = LEVEL_SIZE(level);
+            return (e & PTE_ADDR_MASK & ~(size - 1)) + (virt & (size - 1));
+        }
+        table = table_of(e);
+    }
+    return 0;
+}
+
+struct Region {
+    uint64_t start;
+    uint64_t size;
+    int used;
+};
+
+static struct Region regions[VMM_MAX_REGIONS];
+static uint64_t demand_next = VMM_DEMAND_BASE;
+static uint64_t demand_pages = 0;
+
+#define PF_PRESENT 0x1 // error code: protection violation, not a missing page
+
+static struct Region* find_region(uint64_t addr) {
+    for (int i = 0; i < VMM_MAX_REGIONS; i++) {
+        struct Region* r = &regions[i];
+        if (r->used && addr >= r->start && addr - r->start < r->size) return r;
+    }
+    return 0;
+}
+
+void* vmm_reserve(uint64_t size) {
+    if (size == 0) return 0;
+    size = (size + VMM_PAGE_SIZE - 1) & ~(VMM_PAGE_SIZE - 1);
+    for (int i = 0; i < VMM_MAX_REGIONS; i++) {
+        struct Region* r = &regions[i];
+        if (r->used) continue;
+        r->start = demand_next;
+        r->size = size;
+        r->used = 1;
+        // Next region on a 2 MiB boundary, after an unmapped guard gap
+        demand_next = ((demand_next + size + VMM_PAGE_2M - 1) & ~(VMM_PAGE_2M - 1)) + VMM_PAGE_2M;
+        return (void*)r->start;
+    }
+    return 0;
+}
+
+void vmm_discard(void* addr, uint64_t size) {
+    uint64_t start = (uint64_t)addr & ~(VMM_PAGE_SIZE - 1);
+    uint64_t end = ((uint64_t)addr + size + VMM_PAGE_SIZE - 1) & ~(VMM_PAGE_SIZE - 1);
+    for (uint64_t v = start; v < end; v += VMM_PAGE_SIZE) {
+        if (!find_region(v)) continue;
+        uint64_t phys = vmm_translate(v);
+        if (!phys) continue;
+        vmm_unmap(v, VMM_PAGE_SIZE);
+        pmm_free(phys, 0);
+        demand_pages--;
+    }
+}
+
+void vmm_release(void* addr) {
+    struct Region* r = find_region((uint64_t)addr);
+    if (!r) return;
+    vmm_discard((void*)r->start, r->size);
+    r->used = 0;
+}
+
+int vmm_handle_fault(uint64_t fault_addr, uint64_t err_code) {
+    if (err_code & PF_PRESENT) return 0;
+    if (!find_region(fault_addr)) return 0;
+    uint64_t page = pmm_alloc(0);
+    if (!page) return 0;
+    uint64_t* p = (uint64_t*)page;
+    for (int i = 0; i < (int)(VMM_PAGE_SIZE / 8); i++) p[i] = 0;
+    if (!vmm_map(fault_addr & ~(VMM_PAGE_SIZE - 1), page, VMM_PAGE_SIZE, VMM_CACHE_WB | VMM_WRITE)) {
+        pmm_free(page, 0);
+        return 0;
+    }
+    demand_pages++;
+    return 1;
+}
+
+uint64_t vmm_demand_pages(void) {
+    return demand_pages;
+}
@@ -0,0 +1,163 @@
+#include "ui/assets.h"
+#include "drivers/display/image.h"
+#include "drivers/display/blend.h"
+#include "drivers/display/scale.h"
+#include "drivers/framebuffer.h"
+#include "mm/heap.h"
+
+// 48x48 RGBA QOI: the accent-colored app logo, drawn at about 1/16 of the
+// screen height
+#define LOGO_SIZE 48
+#define LOGO_MIN  24
+#define LOGO_MAX  128
+static const uint8_t logo_qoi[] = {
+    0x71, 0x6f, 0x69, 0x66, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x30,
+    0x04, 0x00, 0xff, 0x44, 0x88, 0xcc, 0x00, 0xc4, 0xff, 0x44, 0x88, 0xcc,
+    0x13, 0xff, 0x44, 0x88, 0xcc, 0x6e, 0xff, 0x44, 0x88, 0xcc, 0xb4, 0xff,
+    0x44, 0x88, 0xcc, 0xe4, 0xff, 0x44, 0x88, 0xcc, 0xfc, 0xff, 0x44, 0x88,
+    0xcc, 0xff, 0xd8, 0x1c, 0x14, 0x04, 0x02, 0x19, 0x08, 0xc4, 0x55, 0xc3,
+    0xff, 0x43, 0x87, 0xcb, 0x85, 0xff, 0x43, 0x87, 0xcb, 0xfc, 0xff, 0x43,
+    0x87, 0xcb, 0xff, 0xe0, 0x0d, 0x30, 0x39, 0xc3, 0x55, 0xc1, 0xff, 0x42,
+    0x86, 0xca, 0x2a, 0xff, 0x42, 0x86, 0xca, 0xcc, 0xff, 0x42, 0x86, 0xca,
+    0xff, 0xe4, 0x2e, 0x38, 0x2a, 0xc1, 0x65, 0xc0, 0xff, 0x42, 0x85, 0xc9,
+    0x2a, 0xff, 0x42, 0x85, 0xc9, 0xe4, 0xff, 0x42, 0x85, 0xc9, 0xff, 0xe6,
+    0x2a, 0x2c, 0x1e, 0xc0, 0x55, 0xc0, 0xff, 0x41, 0x84, 0xc8, 0xcc, 0xff,
+    0x41, 0x84, 0xc8, 0xff, 0xe8, 0x13, 0x0f, 0xc0, 0x66, 0xff, 0x41, 0x83,
+    0xc8, 0x85, 0xff, 0x41, 0x83, 0xc8, 0xff, 0xea, 0x01, 0x0a, 0xff, 0x40,
+    0x82, 0xc7, 0x13, 0xff, 0x40, 0x82, 0xc7, 0xfc, 0xff, 0x40, 0x82, 0xc7,
+    0xff, 0xea, 0x0f, 0x0c, 0xff, 0x40, 0x81, 0xc6, 0x6e, 0xff, 0x40, 0x81,
+    0xc6, 0xff, 0xec, 0x29, 0xff, 0x3f, 0x81, 0xc5, 0xb4, 0xff, 0x3f, 0x81,
+    0xc5, 0xff, 0xd1, 0xae, 0xf0, 0xfe, 0x79, 0xa7, 0xd6, 0xfe, 0x91, 0xb7,
+    0xde, 0xa8, 0xc4, 0xc0, 0x0d, 0x3d, 0x09, 0x1a, 0xd1, 0x21, 0xff, 0x3f,
+    0x80, 0xc5, 0xe4, 0xff, 0x3f, 0x80, 0xc5, 0xff, 0xc9, 0xfe, 0x88, 0xb0,
+    0xdb, 0x15, 0xc2, 0xae, 0xf0, 0xfe, 0x9d, 0xbe, 0xe2, 0xfe, 0xdc, 0xe8,
+    0xf4, 0xfe, 0xff, 0xff, 0xff, 0xc6, 0x3d, 0x30, 0x04, 0x15, 0xce, 0x2c,
+    0xff, 0x3e, 0x7f, 0xc4, 0xfc, 0xff, 0x3e, 0x7f, 0xc4, 0xff, 0xc9, 0x26,
+    0xfe, 0x87, 0xaf, 0xda, 0x06, 0xa6, 0xb5, 0xfe, 0xa9, 0xc6, 0xe5, 0x26,
+    0xcc, 0x11, 0x14, 0x06, 0xcc, 0x25, 0xff, 0x3d, 0x7e, 0xc3, 0xff, 0xca,
+    0x26, 0xc0, 0xfe, 0x86, 0xaf, 0xda, 0xfe, 0xe8, 0xf0, 0xf8, 0x26, 0xce,
+    0x25, 0xfe, 0x77, 0xa5, 0xd5, 0x37, 0xcc, 0x65, 0xca, 0xfe, 0xff, 0xff,
+    0xff, 0xd4, 0xfe, 0x90, 0xb5, 0xdc, 0x2b, 0xcb, 0x56, 0xca, 0x26, 0xc7,
+    0xfe, 0xd7, 0xe4, 0xf2, 0xfe, 0xb2, 0xcb, 0xe7, 0x94, 0x2e, 0xc0, 0x13,
+    0x0c, 0x26, 0xc6, 0xfe, 0x8f, 0xb4, 0xdc, 0x23, 0xca, 0x65, 0xc9, 0xfe,
+    0x76, 0xa3, 0xd4, 0x26, 0xc4, 0x9d, 0x7a, 0x37, 0xfe, 0x54, 0x8b, 0xc9,
+    0x17, 0xc4, 0x27, 0x37, 0x04, 0x26, 0xc4, 0x12, 0x17, 0xc9, 0x55, 0xc8,
+    0xa6, 0xb5, 0x25, 0x26, 0xc4, 0xfe, 0x85, 0xac, 0xd8, 0xfe, 0x3b, 0x7a,
+    0xc0, 0xc8, 0xfe, 0x53, 0x8b, 0xc8, 0xfe, 0xc4, 0xd7, 0xec, 0x26, 0xc3,
+    0x25, 0x16, 0x08, 0xc8, 0x69, 0xc8, 0xfe, 0xa8, 0xc4, 0xe3, 0x26, 0xc6,
+    0xfe, 0x85, 0xac, 0xd7, 0xfe, 0x3b, 0x7a, 0xbf, 0xc9, 0xfe, 0xb2, 0xcb,
+    0xe6, 0x26, 0xc3, 0x36, 0x01, 0xc8, 0x55, 0xc7, 0xaf, 0xf0, 0x26, 0xc8,
+    0xfe, 0x85, 0xac, 0xd7, 0x32, 0xc9, 0x28, 0x26, 0xc3, 0x30, 0x32, 0xc7,
+    0x66, 0xc7, 0xfe, 0x9b, 0xba, 0xde, 0x26, 0xc2, 0x04, 0xfe, 0x85, 0xab,
+    0xd7, 0x26, 0xc3, 0x3c, 0x2d, 0xc8, 0xfe, 0x52, 0x89, 0xc6, 0x04, 0x26,
+    0xc2, 0x3a, 0x2d, 0xc7, 0x55, 0xc7, 0xfe, 0xdb, 0xe6, 0xf3, 0x26, 0xc2,
+    0xfe, 0x9e, 0xbd, 0xdf, 0x1e, 0xfe, 0x84, 0xab, 0xd6, 0x26, 0xc3, 0x32,
+    0x1e, 0xc8, 0x19, 0x26, 0xc2, 0x29, 0x1e, 0xc7, 0x55, 0xc6, 0xaf, 0xf0,
+    0x26, 0xc3, 0xfe, 0x51, 0x87, 0xc4, 0x0f, 0xc0, 0xfe, 0x83, 0xaa, 0xd5,
+    0x26, 0xc3, 0x23, 0x0f, 0xc7, 0x27, 0x26, 0xc3, 0x0d, 0x0f, 0xc6, 0x65,
+    0xc6, 0xfe, 0x74, 0x9e, 0xcf, 0x26, 0xc2, 0xfe, 0xd6, 0xe3, 0xf1, 0x03,
+    0xc2, 0xfe, 0x83, 0xa9, 0xd5, 0x26, 0xc3, 0x1e, 0x03, 0xc7, 0x3d, 0x26,
+    0xc2, 0x10, 0x03, 0xc6, 0x56, 0xc6, 0xfe, 0x8d, 0xaf, 0xd8, 0x26, 0xc2,
+    0xfe, 0xb0, 0xc8, 0xe4, 0x3b, 0xc3, 0x1e, 0x26, 0xc3, 0x1e, 0x3b, 0xc6,
+    0x29, 0x26, 0xc2, 0x2f, 0x3b, 0xc6, 0x65, 0xc6, 0xfe, 0x99, 0xb8, 0xdc,
+    0x26, 0xc2, 0xfe, 0x9d, 0xbb, 0xdd, 0x2f, 0xc4, 0xfe, 0x83, 0xa8, 0xd4,
+    0x26, 0xc3, 0x12, 0x2f, 0xc5, 0x3e, 0x26, 0xc2, 0x1c, 0x2f, 0xc6, 0x59,
+    0xc6, 0xfe, 0x99, 0xb8, 0xdb, 0x26, 0xc2, 0x3e, 0x25, 0xc5, 0xfe, 0x82,
+    0xa8, 0xd4, 0x26, 0xc3, 0x0f, 0x25, 0xc4, 0x3e, 0x26, 0xc2, 0x15, 0x25,
+    0xc6, 0x65, 0xc6, 0xfe, 0x8c, 0xae, 0xd6, 0x26, 0xc2, 0xfe, 0xb0, 0xc8,
+    0xe3, 0xfe, 0x36, 0x72, 0xb8, 0xc6, 0xfe, 0x82, 0xa7, 0xd3, 0x26, 0xc3,
+    0x03, 0x19, 0xc3, 0x22, 0x26, 0xc2, 0xfe, 0x8c, 0xae, 0xd6, 0xfe, 0x36,
+    0x72, 0xb8, 0xc6, 0x56, 0xc6, 0xfe, 0x72, 0x9c, 0xcd, 0x26, 0xc2, 0xfe,
+    0xd5, 0xe2, 0xf0, 0x11, 0xc7, 0xfe, 0x81, 0xa7, 0xd3, 0x26, 0xc3, 0x00,
+    0x11, 0xc2, 0x2e, 0x26, 0xc2, 0x32, 0x11, 0xc6, 0x65, 0xc6, 0xb0, 0xe0,
+    0x26, 0xc3, 0xfe, 0x4e, 0x82, 0xc0, 0x05, 0xc7, 0xfe, 0x81, 0xa6, 0xd2,
+    0x26, 0xc3, 0x34, 0x05, 0xc0, 0x29, 0x26, 0xc3, 0x0f, 0x05, 0xc6, 0x55,
+    0xc7, 0xfe, 0xda, 0xe5, 0xf2, 0x26, 0xc2, 0xfe, 0x9c, 0xb9, 0xdb, 0x36,
+    0xc8, 0x34, 0x26, 0xc3, 0x34, 0x36, 0x23, 0x26, 0xc2, 0x1a, 0x36, 0xc7,
+    0x55, 0xc7, 0xfe, 0x97, 0xb5, 0xd9, 0x26, 0xc2, 0x9d, 0x69, 0xfe, 0x4c,
+    0x80, 0xbe, 0x27, 0xc8, 0xfe, 0x80, 0xa5, 0xd1, 0x26, 0xc3, 0x25, 0x3a,
+    0x26, 0xc2, 0x32, 0x27, 0xc7, 0x66, 0xc7, 0xb0, 0xe0, 0x26, 0xc3, 0xfe,
+    0xc2, 0xd3, 0xe9, 0x22, 0xc9, 0xfe, 0x80, 0xa4, 0xd1, 0x26, 0xc8, 0x2c,
+    0x22, 0xc7, 0x55, 0xc8, 0xfe, 0xa4, 0xbe, 0xde, 0x26, 0xc3, 0xfe, 0xae,
+    0xc5, 0xe1, 0x13, 0xc9, 0xfe, 0x80, 0xa4, 0xd0, 0x26, 0xc6, 0x29, 0x13,
+    0xc8, 0x69, 0xc8, 0xa7, 0xb5, 0xfe, 0xe7, 0xee, 0xf6, 0x26, 0xc3, 0xfe,
+    0xc2, 0xd3, 0xe8, 0xfe, 0x4b, 0x7e, 0xbc, 0x0c, 0xc8, 0x19, 0x26, 0xc4,
+    0x0a, 0x29, 0x0c, 0xc8, 0x55, 0xc9, 0xfe, 0x6f, 0x97, 0xc9, 0x26, 0xc4,
+    0x3a, 0xfe, 0x9a, 0xb7, 0xd9, 0xfe, 0x4b, 0x7d, 0xbc, 0x3d, 0xc4, 0x2b,
+    0x05, 0x3a, 0x26, 0xc4, 0x34, 0x3d, 0xc9, 0x65, 0xca, 0xfe, 0x89, 0xaa,
+    0xd2, 0x26, 0xc6, 0xfe, 0xd4, 0xe0, 0xef, 0xfe, 0xae, 0xc4, 0xe0, 0x92,
+    0x2f, 0xc0, 0x33, 0x1a, 0x26, 0xc7, 0x31, 0xca, 0x56, 0xcb, 0xfe, 0x89,
+    0xa9, 0xd2, 0x26, 0xd4, 0x29, 0xca, 0x65, 0xcc, 0xfe, 0x6e, 0x95, 0xc8,
+    0xfe, 0xe7, 0xed, 0xf6, 0x26, 0xce, 0x05, 0xfe, 0x7e, 0xa1, 0xce, 0x26,
+    0xc0, 0x1d, 0xca, 0xff, 0x2f, 0x67, 0xaf, 0xfc, 0xff, 0x2f, 0x67, 0xaf,
+    0xff, 0xcc, 0xa7, 0xb5, 0xfe, 0xa3, 0xbc, 0xdc, 0x26, 0xcc, 0x0e, 0x2b,
+    0x99, 0x5b, 0xfe, 0x7e, 0xa1, 0xcd, 0x26, 0x0e, 0xc9, 0x2d, 0xff, 0x2e,
+    0x66, 0xae, 0xe4, 0xff, 0x2e, 0x66, 0xae, 0xff, 0xce, 0xb1, 0xe0, 0xfe,
+    0x95, 0xb1, 0xd6, 0xfe, 0xd9, 0xe3, 0xf0, 0x26, 0xc6, 0x3f, 0x03, 0x18,
+    0xfe, 0x2e, 0x66, 0xae, 0xc2, 0xfe, 0x7d, 0xa0, 0xcd, 0x3f, 0xc9, 0x16,
+    0xff, 0x2e, 0x65, 0xae, 0xb4, 0xff, 0x2e, 0x65, 0xae, 0xff, 0xd1, 0xb1,
+    0xe0, 0xfe, 0x6d, 0x93, 0xc6, 0xfe, 0x87, 0xa7, 0xd1, 0x03, 0xc0, 0x04,
+    0x05, 0x13, 0x3a, 0xd1, 0x01, 0xff, 0x2d, 0x65, 0xad, 0x6e, 0xff, 0x2d,
+    0x65, 0xad, 0xff, 0xec, 0x35, 0xff, 0x2d, 0x64, 0xac, 0x13, 0xff, 0x2d,
+    0x64, 0xac, 0xfc, 0xff, 0x2d, 0x64, 0xac, 0xff, 0xea, 0x03, 0x00, 0xff,
+    0x2c, 0x63, 0xab, 0x00, 0xff, 0x2c, 0x63, 0xab, 0x85, 0xff, 0x2c, 0x63,
+    0xab, 0xff, 0xea, 0x17, 0x20, 0x66, 0xc0, 0xff, 0x2c, 0x62, 0xab, 0xcc,
+    0xff, 0x2c, 0x62, 0xab, 0xff, 0xe8, 0x1f, 0x1b, 0xc0, 0x55, 0xc0, 0xff,
+    0x2b, 0x61, 0xaa, 0x2a, 0xff, 0x2b, 0x61, 0xaa, 0xe4, 0xff, 0x2b, 0x61,
+    0xaa, 0xff, 0xe6, 0x18, 0x1a, 0x0c, 0xc0, 0x65, 0xc1, 0xff, 0x2b, 0x60,
+    0xa9, 0x2a, 0xff, 0x2b, 0x60, 0xa9, 0xcc, 0xff, 0x2b, 0x60, 0xa9, 0xff,
+    0xe4, 0x04, 0x0e, 0x00, 0xc1, 0x55, 0xc3, 0xff, 0x2a, 0x5f, 0xa8, 0x85,
+    0xff, 0x2a, 0x5f, 0xa8, 0xfc, 0xff, 0x2a, 0x5f, 0xa8, 0xff, 0xe0, 0x05,
+    0x28, 0x31, 0xc9, 0xff, 0x2a, 0x5f, 0xa8, 0x13, 0xff, 0x2a, 0x5f, 0xa8,
+    0x6e, 0xff, 0x2a, 0x5f, 0xa8, 0xb4, 0xff, 0x2a, 0x5f, 0xa8, 0xe4, 0x05,
+    0x26, 0xd8, 0x05, 0x3d, 0x2d, 0x2b, 0x02, 0x31, 0xc4, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01,
+};
+
+static uint32_t logo_pixels[LOGO_SIZE * LOGO_SIZE];
+static struct UiImage logo = { logo_pixels, 0, 0 };
+
+// Decode straight into dst row by row, premultiplying on the way
+static int decode(const uint8_t* data, uint32_t size, uint32_t* dst, uint32_t max_w, uint32_t max_h,
+                  struct UiImage* out) {
+    struct ImageDecoder dec;
+    if (!image_open(&dec, data, size) || dec.width > max_w || dec.height > max_h) return 0;
+    for (uint32_t y = 0; y < dec.height; y++) {
+        uint32_t* row = dst + y * dec.width;
+        const uint32_t* px = image_next_row(&dec, row);
+        if (!px) return 0;
+        for (uint32_t x = 0; x < dec.width; x++) {
+            row[x] = dec.has_alpha ? blend_premultiply(px[x]) : 0xFF000000 | px[x];
+        }
+    }
+    out->width = dec.width;
+    out->height = dec.height;
+    return 1;
+}
+
+// Resample a decoded image to size x size (premultiplied pixels filter
+// correctly with bilinear weights); keeps the original if memory is short
+static void fit(struct UiImage* img, uint32_t size) {
+    if (!img->width || (img->width == size && img->height == size)) return;
+    uint32_t* dst = (uint32_t*)kmalloc((size_t)size * size * 4);
+    if (!dst) return;
+    if (!scale_image(img->pixels, img->width, img->height, img->width, dst, size, size, size, SCALE_BILINEAR)) {
+        kfree(dst);
+        return;
+    }
+    img->pixels = dst;
+    img->width = size;
+    img->height = size;
+}
+
+void assets_init(void) {
+    decode(logo_qoi, sizeof(logo_qoi), logo_pixels, LOGO_SIZE, LOGO_SIZE, &logo);
+    uint32_t size = fb.height / 16;
+    if (size < LOGO_MIN) size = LOGO_MIN;
+    if (size > LOGO_MAX) size = LOGO_MAX;
+    fit(&logo, size);
+}
+
+const struct UiImage* assets_logo(void) {
+    return &logo;
+}
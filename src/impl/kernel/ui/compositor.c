@@ -0,0 +1,162 @@
+#include "ui/compositor.h"
+#include "drivers/framebuffer.h"
+
+// Stack of surfaces, [0] = topmost
+static struct Surface* stack[SURFACE_MAX];
+static int stack_count = 0;
+static uint32_t background = 0xFF000000;
+static struct CompositorStats stats = {0};
+
+// Screen areas uncovered by stack changes (hide, remove), painted from the top
+#define COMPOSITOR_MAX_EXPOSE 8
+static struct FbRect exposed[COMPOSITOR_MAX_EXPOSE];
+static int exposed_count = 0;
+
+static struct FbRect surface_rect(const struct Surface* s) {
+    struct FbRect r = { s->target.x, s->target.y, s->target.width, s->target.height };
+    return r;
+}
+
+static int rect_intersect(const struct FbRect* a, const struct FbRect* b, struct FbRect* out) {
+    uint32_t x1 = a->x > b->x ? a->x : b->x;
+    uint32_t y1 = a->y > b->y ? a->y : b->y;
+    uint32_t x2 = (a->x + a->w < b->x + b->w) ? a->x + a->w : b->x + b->w;
+    uint32_t y2 = (a->y + a->h < b->y + b->h) ? a->y + a->h : b->y + b->h;
+    if (x1 >= x2 || y1 >= y2) return 0;
+    out->x = x1; out->y = y1; out->w = x2 - x1; out->h = y2 - y1;
+    return 1;
+}
+
+// Split r minus hole (hole inside r) into up to 4 bands; returns the count
+static int rect_subtract(const struct FbRect* r, const struct FbRect* hole, struct FbRect* out) {
+    int n = 0;
+    if (hole->y > r->y) {
+        out[n].x = r->x; out[n].y = r->y; out[n].w = r->w; out[n].h = hole->y - r->y; n++;
+    }
+    if (hole->y + hole->h < r->y + r->h) {
+        out[n].x = r->x; out[n].y = hole->y + hole->h;
+        out[n].w = r->w; out[n].h = r->y + r->h - (hole->y + hole->h); n++;
+    }
+    if (hole->x > r->x) {
+        out[n].x = r->x; out[n].y = hole->y; out[n].w = hole->x - r->x; out[n].h = hole->h; n++;
+    }
+    if (hole->x + hole->w < r->x + r->w) {
+        out[n].x = hole->x + hole->w; out[n].y = hole->y;
+        out[n].w = r->x + r->w - (hole->x + hole->w); out[n].h = hole->h; n++;
+    }
+    return n;
+}
+
+// Paint r with what is visible from stack level 'level' down: the first
+// surface that overlaps gets its part copied, the rest falls through.
+static void paint_from(struct FbRect r, int level) {
+    for (int i = level; i < stack_count; i++) {
+        struct Surface* s = stack[i];
+        struct FbRect sr = surface_rect(s);
+        struct FbRect part;
+        if (!s->visible || !rect_intersect(&r, &sr, &part)) continue;
+
+        framebuffer_compose(&s->target, part.x, part.y, part.w, part.h);
+        stats.rects++;
+        stats.pixels += (uint64_t)part.w * part.h;
+
+        struct FbRect rest[4];
+        int n = rect_subtract(&r, &part, rest);
+        for (int k = 0; k < n; k++) paint_from(rest[k], i + 1);
+        return;
+    }
+    // Nothing covers it
+    framebuffer_draw_rect(r.x, r.y, r.w, r.h, background);
+}
+
+// Copy the parts of r (inside stack[level]) not covered by surfaces above it
+static void paint_unoccluded(struct FbRect r, int level, int above) {
+    for (int i = above; i < level; i++) {
+        struct Surface* s = stack[i];
+        struct FbRect sr = surface_rect(s);
+        struct FbRect hidden;
+        if (!s->visible || !rect_intersect(&r, &sr, &hidden)) continue;
+
+        stats.culled_pixels += (uint64_t)hidden.w * hidden.h;
+        struct FbRect rest[4];
+        int n = rect_subtract(&r, &hidden, rest);
+        for (int k = 0; k < n; k++) paint_unoccluded(rest[k], level, i + 1);
+        return;
+    }
+    framebuffer_compose(&stack[level]->target, r.x, r.y, r.w, r.h);
+    stats.rects++;
+    stats.pixels += (uint64_t)r.w * r.h;
+}
+
+static void expose(struct FbRect r) {
+    if (exposed_count == COMPOSITOR_MAX_EXPOSE) {
+        // Full: fall back to the whole screen
+        exposed[0].x = 0; exposed[0].y = 0; exposed[0].w = fb.width; exposed[0].h = fb.height;
+        exposed_count = 1;
+        return;
+    }
+    exposed[exposed_count++] = r;
+}
+
+void compositor_add(struct Surface* s) {
+    if (!s || stack_count == SURFACE_MAX) return;
+    for (int i = stack_count; i > 0; i--) stack[i] = stack[i - 1];
+    stack[0] = s;
+    stack_count++;
+    s->exposed = 1;
+}
+
+void compositor_remove(struct Surface* s) {
+    for (int i = 0; i < stack_count; i++) {
+        if (stack[i] != s) continue;
+        for (int j = i; j < stack_count - 1; j++) stack[j] = stack[j + 1];
+        stack_count--;
+        if (s->visible) expose(surface_rect(s));
+        return;
+    }
+}
+
+void compositor_raise(struct Surface* s) {
+    if (stack_count == 0 || stack[0] == s) return;
+    for (int i = 1; i < stack_count; i++) {
+        if (stack[i] != s) continue;
+        for (int j = i; j > 0; j--) stack[j] = stack[j - 1];
+        stack[0] = s;
+        s->exposed = 1;
+        return;
+    }
+}
+
+void compositor_set_visible(struct Surface* s, int visible) {
+    if (s->visible == visible) return;
+    s->visible = visible;
+    if (visible) s->exposed = 1;
+    else expose(surface_rect(s));
+}
+
+void compositor_set_background(uint32_t color) {
+    background = color;
+}
+
+void compositor_compose(void) {
+    framebuffer_bind_target(0);
+
+    for (int e = 0; e < exposed_count; e++) paint_from(exposed[e], 0);
+    exposed_count = 0;
+
+    for (int i = 0; i < stack_count; i++) {
+        struct Surface* s = stack[i];
+        struct FbRect* d = &s->target.dirty;
+        if (s->visible && (s->exposed || d->w > 0)) {
+            struct FbRect r = s->exposed ? surface_rect(s) : *d;
+            paint_unoccluded(r, i, 0);
+        }
+        s->exposed = 0;
+        d->w = 0;
+        d->h = 0;
+    }
+}
+
+struct CompositorStats compositor_get_stats(void) {
+    return stats;
+}
@@ -0,0 +1,491 @@
+#include "ui/display_list.h"
+#include "drivers/framebuffer.h"
+#include "drivers/display/text.h"
+#include "drivers/display/raster.h"
+
+static struct DisplayList* recording = 0;
+
+// --- Damage accumulated while diffing ---
+#define DL_MAX_DAMAGE 32
+#define DL_DAMAGE_MERGE_SLACK 2048
+
+struct DlRect { int32_t x1, y1, x2, y2; };
+
+static struct DlRect damage[DL_MAX_DAMAGE];
+static int damage_count = 0;
+
+static int64_t dl_rect_area(const struct DlRect* r) {
+    return (int64_t)(r->x2 - r->x1) * (r->y2 - r->y1);
+}
+
+static struct DlRect dl_rect_union(const struct DlRect* a, const struct DlRect* b) {
+    struct DlRect u;
+    u.x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    u.y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    u.x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    u.y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+    return u;
+}
+
+static void damage_add(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (w <= 0 || h <= 0) return;
+    struct DlRect r = { x, y, x + w, y + h };
+
+    int merged = 1;
+    while (merged) {
+        merged = 0;
+        for (int i = 0; i < damage_count; i++) {
+            struct DlRect u = dl_rect_union(&damage[i], &r);
+            if (dl_rect_area(&u) <= dl_rect_area(&damage[i]) + dl_rect_area(&r) + DL_DAMAGE_MERGE_SLACK) {
+                r = u;
+                damage[i] = damage[--damage_count];
+                merged = 1;
+                break;
+            }
+        }
+    }
+
+    // Full: fold everything into one bounding box
+    if (damage_count >= DL_MAX_DAMAGE) {
+        for (int i = 0; i < damage_count; i++) r = dl_rect_union(&damage[i], &r);
+        damage_count = 0;
+    }
+    damage[damage_count++] = r;
+}
+
+// --- Primitive hashing (FNV-1a over the fields and text) ---
+
+static uint64_t hash_bytes(uint64_t h, const void* data, uint32_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint32_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+static uint64_t prim_hash(const struct DlPrim* p, const char* text) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = hash_bytes(h, &p->type, 1);
+    h = hash_bytes(h, &p->scale, 1);
+    h = hash_bytes(h, &p->x, 16); // x, y, w, h
+    h = hash_bytes(h, &p->fg, 8); // fg, bg
+    if (p->type == DL_CHAR) h = hash_bytes(h, &p->text, 4);
+    else if (text) h = hash_bytes(h, text, p->len);
+    return h;
+}
+
+// --- Multiset of the previous frame's hashes (open addressing) ---
+#define DL_HASH_SLOTS 65536 // power of two, >= 2 * largest prim_capacity
+
+static uint64_t set_keys[DL_HASH_SLOTS];
+static uint32_t set_counts[DL_HASH_SLOTS];
+static uint8_t set_occupied[DL_HASH_SLOTS];
+static uint32_t set_used[DL_HASH_SLOTS]; // occupied slots, reset after the diff
+static uint32_t set_used_count = 0;
+
+static uint32_t set_find(uint64_t key) {
+    uint32_t i = (uint32_t)(key ^ (key >> 32)) & (DL_HASH_SLOTS - 1);
+    while (set_occupied[i] && set_keys[i] != key) i = (i + 1) & (DL_HASH_SLOTS - 1);
+    return i;
+}
+
+static void set_insert(uint64_t key) {
+    uint32_t i = set_find(key);
+    if (!set_occupied[i]) {
+        set_occupied[i] = 1;
+        set_keys[i] = key;
+        set_counts[i] = 0;
+        set_used[set_used_count++] = i;
+    }
+    set_counts[i]++;
+}
+
+// Remove one occurrence; returns 1 if key was present
+static int set_take(uint64_t key) {
+    uint32_t i = set_find(key);
+    if (!set_occupied[i] || set_counts[i] == 0) return 0;
+    set_counts[i]--;
+    return 1;
+}
+
+static void set_clear(void) {
+    for (uint32_t i = 0; i < set_used_count; i++) set_occupied[set_used[i]] = 0;
+    set_used_count = 0;
+}
+
+// --- Rasterization ---
+
+// Pool data hashed with the primitive (text, or shape points)
+static const char* prim_data(const struct DlFrame* f, const struct DlPrim* p) {
+    switch (p->type) {
+    case DL_TEXT:
+    case DL_TEXT_SCALED:
+    case DL_LINE:
+    case DL_POLYGON:
+        return f->text + p->text;
+    }
+    return 0;
+}
+
+// Unpack pool points (int16 pairs relative to the bounds) to screen space
+static uint32_t prim_points(const struct DlFrame* f, const struct DlPrim* p, int32_t* xy) {
+    const uint8_t* src = (const uint8_t*)f->text + p->text;
+    uint32_t n = p->len / 4;
+    for (uint32_t i = 0; i < 2 * n; i++) {
+        int16_t v = (int16_t)(src[2 * i] | (src[2 * i + 1] << 8));
+        xy[i] = v + ((i & 1) ? p->y : p->x);
+    }
+    return n;
+}
+
+static void prim_draw(const struct DlFrame* f, const struct DlPrim* p) {
+    switch (p->type) {
+    case DL_RECT:
+        if (p->x < 0 || p->y < 0) {
+            int x = p->x < 0 ? 0 : p->x, y = p->y < 0 ? 0 : p->y;
+            int w = p->w - (x - p->x), h = p->h - (y - p->y);
+            if (w > 0 && h > 0) framebuffer_draw_rect(x, y, w, h, p->fg);
+        } else {
+            framebuffer_draw_rect(p->x, p->y, p->w, p->h, p->fg);
+        }
+        break;
+    case DL_TEXT:
+        text_draw_string(f->text + p->text, p->x, p->y, p->fg, p->bg);
+        break;
+    case DL_TEXT_SCALED:
+        text_draw_string_scaled(f->text + p->text, p->x, p->y, p->fg, p->bg, p->scale);
+        break;
+    case DL_CHAR:
+        text_draw_char((char)p->text, p->x, p->y, p->fg, p->bg);
+        break;
+    case DL_LINE: {
+        int32_t xy[4];
+        prim_points(f, p, xy);
+        raster_line(xy[0], xy[1], xy[2], xy[3], p->fg, p->scale);
+        break;
+    }
+    case DL_CIRCLE:
+        raster_circle(p->x + p->w / 2, p->y + p->h / 2, p->w / 2, (int32_t)p->bg, p->fg, p->scale);
+        break;
+    case DL_ROUND_RECT:
+        raster_round_rect(p->x, p->y, p->w, p->h, (int32_t)p->bg, p->fg, p->scale);
+        break;
+    case DL_POLYGON: {
+        int32_t xy[2 * RASTER_MAX_POINTS];
+        uint32_t n = prim_points(f, p, xy);
+        raster_polygon(xy, n, p->fg, p->scale);
+        break;
+    }
+    case DL_IMAGE: {
+        const uint32_t* pixels = (const uint32_t*)(((uint64_t)p->bg << 32) | p->fg);
+        framebuffer_blend_bitmap(pixels, p->x, p->y, (uint32_t)p->w, (uint32_t)p->h, (uint32_t)p->w);
+        break;
+    }
+    }
+}
+
+static int prim_hits(const struct DlPrim* p, const struct DlRect* r) {
+    return p->x < r->x2 && p->x + p->w > r->x1 && p->y < r->y2 && p->y + p->h > r->y1;
+}
+
+// --- Public API ---
+
+void display_list_init(struct DisplayList* dl, struct DlPrim* prim_storage, uint32_t prim_capacity,
+                       char* text_storage, uint32_t text_capacity) {
+    for (int i = 0; i < 2; i++) {
+        dl->frames[i].prims = prim_storage + i * prim_capacity;
+        dl->frames[i].count = 0;
+        dl->frames[i].text = text_storage + i * text_capacity;
+        dl->frames[i].text_used = 0;
+    }
+    dl->cur = 0;
+    dl->prim_capacity = prim_capacity;
+    dl->text_capacity = text_capacity;
+    dl->overflow = 0;
+    dl->prev_valid = 0;
+    dl->pending_count = 0;
+}
+
+void display_list_invalidate(struct DisplayList* dl) {
+    dl->prev_valid = 0;
+    dl->pending_count = 0;
+}
+
+static void pending_add(struct DisplayList* dl, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (w <= 0 || h <= 0) return;
+    if (dl->pending_count == DL_MAX_PENDING) {
+        // Full: fold into the last box
+        struct DlBox* b = &dl->pending[DL_MAX_PENDING - 1];
+        int32_t x2 = (x + w > b->x + b->w) ? x + w : b->x + b->w;
+        int32_t y2 = (y + h > b->y + b->h) ? y + h : b->y + b->h;
+        if (x < b->x) b->x = x;
+        if (y < b->y) b->y = y;
+        b->w = x2 - b->x;
+        b->h = y2 - b->y;
+        return;
+    }
+    struct DlBox* b = &dl->pending[dl->pending_count++];
+    b->x = x; b->y = y; b->w = w; b->h = h;
+}
+
+int display_list_scroll(struct DisplayList* dl, int x, int y, int w, int h, int dy) {
+    if (dy == 0) return 1;
+    if (!dl->prev_valid || dl->overflow || recording == dl || w <= 0 || h <= 0) return 0;
+    if (dy >= h || -dy >= h) return 0; // nothing survives, plain redraw
+
+    framebuffer_scroll_region(x, y, w, h, dy);
+
+    // Shift what is on screen now (frames[cur] until the next begin)
+    struct DlFrame* f = &dl->frames[dl->cur];
+    for (uint32_t i = 0; i < f->count; i++) {
+        struct DlPrim* p = &f->prims[i];
+        int inside = p->x >= x && p->y >= y && p->x + p->w <= x + w && p->y + p->h <= y + h;
+        int outside = p->x >= x + w || p->y >= y + h || p->x + p->w <= x || p->y + p->h <= y;
+        if (outside) continue;
+        if (inside) {
+            p->y += dy;
+            p->hash = prim_hash(p, prim_data(f, p));
+            continue;
+        }
+        // A rect spanning every row of the region looks the same after a
+        // vertical move; anything else straddling the edge is repainted
+        if (p->type == DL_RECT && p->y <= y && p->y + p->h >= y + h) continue;
+        pending_add(dl, p->x, p->y, p->w, p->h);
+        pending_add(dl, p->x, p->y + dy, p->w, p->h);
+    }
+
+    // Rows uncovered by the move
+    if (dy < 0) pending_add(dl, x, y + h + dy, w, -dy);
+    else pending_add(dl, x, y, w, dy);
+    return 1;
+}
+
+void display_list_begin(struct DisplayList* dl) {
+    dl->cur ^= 1;
+    dl->frames[dl->cur].count = 0;
+    dl->frames[dl->cur].text_used = 0;
+    dl->overflow = 0;
+    recording = dl;
+}
+
+// Out of space: draw what we have so far and continue in immediate mode
+static void enter_overflow(struct DisplayList* dl) {
+    struct DlFrame* f = &dl->frames[dl->cur];
+    for (uint32_t i = 0; i < f->count; i++) prim_draw(f, &f->prims[i]);
+    dl->overflow = 1;
+    dl->prev_valid = 0;
+}
+
+static struct DlPrim* prim_alloc(const char* text, uint32_t len, uint32_t* text_off) {
+    struct DisplayList* dl = recording;
+    if (!dl || dl->overflow) return 0;
+    struct DlFrame* f = &dl->frames[dl->cur];
+    if (f->count >= dl->prim_capacity || (text && f->text_used + len + 1 > dl->text_capacity)) {
+        enter_overflow(dl);
+        return 0;
+    }
+    if (text) {
+        *text_off = f->text_used;
+        for (uint32_t i = 0; i < len; i++) f->text[f->text_used + i] = text[i];
+        f->text[f->text_used + len] = '\0';
+        f->text_used += len + 1;
+    }
+    return &f->prims[f->count++];
+}
+
+void dl_draw_rect(int x, int y, int w, int h, uint32_t color) {
+    if (w <= 0 || h <= 0) return;
+    struct DlPrim* p = prim_alloc(0, 0, 0);
+    if (!p) {
+        framebuffer_draw_rect(x, y, w, h, color);
+        return;
+    }
+    p->type = DL_RECT;
+    p->scale = 1;
+    p->len = 0;
+    p->x = x; p->y = y; p->w = w; p->h = h;
+    p->fg = color;
+    p->bg = 0;
+    p->text = 0;
+    p->hash = prim_hash(p, 0);
+}
+
+static void record_text(const char* str, int x, int y, uint32_t fg, uint32_t bg, int scale) {
+    // Bounds over all lines
+    uint32_t len = 0, line = 0, lines = 1, widest = 0;
+    for (; str[len]; len++) {
+        if (str[len] == '\n') { lines++; line = 0; }
+        else if (++line > widest) widest = line;
+    }
+
+    uint32_t off = 0;
+    struct DlPrim* p = prim_alloc(str, len, &off);
+    if (!p) {
+        if (scale == 1) text_draw_string(str, x, y, fg, bg);
+        else text_draw_string_scaled(str, x, y, fg, bg, scale);
+        return;
+    }
+    p->type = (scale == 1) ? DL_TEXT : DL_TEXT_SCALED;
+    p->scale = (uint8_t)scale;
+    p->len = (uint16_t)len;
+    p->x = x; p->y = y;
+    p->w = widest * 8 * scale;
+    p->h = lines * 8 * scale;
+    p->fg = fg;
+    p->bg = bg;
+    p->text = off;
+    p->hash = prim_hash(p, str);
+}
+
+void dl_draw_string(const char* str, int x, int y, uint32_t fg, uint32_t bg) {
+    record_text(str, x, y, fg, bg, 1);
+}
+
+void dl_draw_string_scaled(const char* str, int x, int y, uint32_t fg, uint32_t bg, int scale) {
+    if (scale < 1) return;
+    record_text(str, x, y, fg, bg, scale);
+}
+
+void dl_draw_char(char c, int x, int y, uint32_t fg, uint32_t bg) {
+    struct DlPrim* p = prim_alloc(0, 0, 0);
+    if (!p) {
+        text_draw_char(c, x, y, fg, bg);
+        return;
+    }
+    p->type = DL_CHAR;
+    p->scale = 1;
+    p->len = 1;
+    p->x = x; p->y = y; p->w = 8; p->h = 8;
+    p->fg = fg;
+    p->bg = bg;
+    p->text = (uint8_t)c;
+    p->hash = prim_hash(p, 0);
+}
+
+// Shapes: bounds in x..h, points (if any) go to the pool relative to (x, y)
+static void record_shape(uint8_t type, int x, int y, int w, int h, uint32_t color, uint32_t param,
+                         int flags, const int* xy, int n) {
+    char pts[4 * RASTER_MAX_POINTS];
+    for (int i = 0; i < 2 * n; i++) {
+        int16_t v = (int16_t)(xy[i] - ((i & 1) ? y : x));
+        pts[2 * i] = (char)(v & 0xFF);
+        pts[2 * i + 1] = (char)((v >> 8) & 0xFF);
+    }
+
+    uint32_t off = 0;
+    struct DlPrim* p = prim_alloc(n ? pts : 0, 4 * n, &off);
+    if (!p) {
+        struct DlFrame tmp = { 0, 0, pts, 0 };
+        struct DlPrim q = { type, (uint8_t)flags, (uint16_t)(4 * n), x, y, w, h, color, param, 0, 0 };
+        prim_draw(&tmp, &q);
+        return;
+    }
+    p->type = type;
+    p->scale = (uint8_t)flags;
+    p->len = (uint16_t)(4 * n);
+    p->x = x; p->y = y; p->w = w; p->h = h;
+    p->fg = color;
+    p->bg = param;
+    p->text = off;
+    p->hash = prim_hash(p, n ? pts : 0);
+}
+
+void dl_draw_line(int x0, int y0, int x1, int y1, uint32_t color, int flags) {
+    // One pixel of slack for the AA fringe
+    int x = (x0 < x1 ? x0 : x1) - 1, y = (y0 < y1 ? y0 : y1) - 1;
+    int w = (x0 < x1 ? x1 - x0 : x0 - x1) + 3, h = (y0 < y1 ? y1 - y0 : y0 - y1) + 3;
+    int xy[4] = { x0, y0, x1, y1 };
+    record_shape(DL_LINE, x, y, w, h, color, 0, flags, xy, 2);
+}
+
+void dl_draw_circle(int cx, int cy, int r, int stroke, uint32_t color, int flags) {
+    if (r < 0) return;
+    record_shape(DL_CIRCLE, cx - r, cy - r, 2 * r + 1, 2 * r + 1, color, stroke, flags, 0, 0);
+}
+
+void dl_draw_round_rect(int x, int y, int w, int h, int radius, uint32_t color, int flags) {
+    if (w <= 0 || h <= 0) return;
+    record_shape(DL_ROUND_RECT, x, y, w, h, color, radius, flags, 0, 0);
+}
+
+void dl_draw_polygon(const int* xy, int n, uint32_t color, int flags) {
+    if (n < 3 || n > RASTER_MAX_POINTS) return;
+    int x1 = xy[0], y1 = xy[1], x2 = xy[0], y2 = xy[1];
+    for (int i = 1; i < n; i++) {
+        if (xy[2 * i] < x1) x1 = xy[2 * i];
+        if (xy[2 * i] > x2) x2 = xy[2 * i];
+        if (xy[2 * i + 1] < y1) y1 = xy[2 * i + 1];
+        if (xy[2 * i + 1] > y2) y2 = xy[2 * i + 1];
+    }
+    if (x1 == x2 || y1 == y2) return;
+    record_shape(DL_POLYGON, x1, y1, x2 - x1, y2 - y1, color, 0, flags, xy, n);
+}
+
+void dl_draw_image(const uint32_t* pixels, int x, int y, int w, int h) {
+    if (!pixels || w <= 0 || h <= 0) return;
+    struct DlPrim* p = prim_alloc(0, 0, 0);
+    if (!p) {
+        framebuffer_blend_bitmap(pixels, x, y, (uint32_t)w, (uint32_t)h, (uint32_t)w);
+        return;
+    }
+    p->type = DL_IMAGE;
+    p->scale = 1;
+    p->len = 0;
+    p->x = x; p->y = y; p->w = w; p->h = h;
+    p->fg = (uint32_t)(uint64_t)pixels;
+    p->bg = (uint32_t)((uint64_t)pixels >> 32);
+    p->text = 0;
+    p->hash = prim_hash(p, 0);
+}
+
+// Multiset difference: unmatched primitives on either side are damage. The
+// cur pass consumes every previous hash that is still drawn, so what is left
+// in the set afterwards are exactly the primitives that went away.
+static void diff_frames(const struct DlFrame* prev, const struct DlFrame* cur) {
+    for (uint32_t i = 0; i < prev->count; i++) set_insert(prev->prims[i].hash);
+    for (uint32_t i = 0; i < cur->count; i++) {
+        const struct DlPrim* p = &cur->prims[i];
+        if (!set_take(p->hash)) damage_add(p->x, p->y, p->w, p->h);
+    }
+    for (uint32_t i = 0; i < prev->count; i++) {
+        const struct DlPrim* p = &prev->prims[i];
+        if (set_take(p->hash)) damage_add(p->x, p->y, p->w, p->h);
+    }
+    set_clear();
+}
+
+void display_list_end(struct DisplayList* dl) {
+    recording = 0;
+    if (dl->overflow) { // already drawn immediately
+        dl->pending_count = 0;
+        return;
+    }
+
+    struct DlFrame* cur = &dl->frames[dl->cur];
+    struct DlFrame* prev = &dl->frames[dl->cur ^ 1];
+    damage_count = 0;
+    for (uint32_t i = 0; i < dl->pending_count; i++) {
+        damage_add(dl->pending[i].x, dl->pending[i].y, dl->pending[i].w, dl->pending[i].h);
+    }
+    dl->pending_count = 0;
+
+    if (!dl->prev_valid) {
+        // Nothing retained on screen yet: draw everything
+        for (uint32_t i = 0; i < cur->count; i++) prim_draw(cur, &cur->prims[i]);
+        dl->prev_valid = 1;
+        return;
+    }
+
+    diff_frames(prev, cur);
+
+    // Repaint only the damaged regions, in painter's order, clipped
+    for (int d = 0; d < damage_count; d++) {
+        struct DlRect* r = &damage[d];
+        framebuffer_push_clip(r->x1, r->y1, r->x2 - r->x1, r->y2 - r->y1);
+        for (uint32_t i = 0; i < cur->count; i++) {
+            if (prim_hits(&cur->prims[i], r)) prim_draw(cur, &cur->prims[i]);
+        }
+        framebuffer_pop_clip();
+    }
+}
@@ -0,0 +1,78 @@
+#include "ui/frame_scheduler.h"
+#include "cpu/timer.h"
+#include "cpu/cpu.h"
+
+#define TIMER_HZ 100
+
+static uint32_t frame_rate = 60;
+static int pending = 0;
+static uint64_t pending_slot = 0;   // slot in which the first request arrived
+static uint64_t last_slot = 0;      // slot of the last rendered frame
+static int have_frame = 0;          // last_slot is valid
+static uint64_t frame_start_tsc = 0;
+static struct FrameStats stats = {0};
+
+// TSC rate, refined against the PIT as time passes
+static uint64_t tsc_base = 0;
+static uint64_t tick_base = 0;
+
+// Refresh slot for the current tick: floor(ticks * fps / TIMER_HZ)
+static uint64_t current_slot(void) {
+    return get_tick_count() * frame_rate / TIMER_HZ;
+}
+
+static uint64_t tsc_per_us(void) {
+    uint64_t ticks = get_tick_count() - tick_base;
+    if (ticks == 0) return 0;
+    return (rdtsc() - tsc_base) / (ticks * (1000000 / TIMER_HZ));
+}
+
+void frame_scheduler_init(uint32_t fps) {
+    if (fps == 0 || fps > TIMER_HZ * 10) fps = 60;
+    frame_rate = fps;
+    pending = 0;
+    tick_base = get_tick_count();
+    tsc_base = rdtsc();
+    have_frame = 0; // allow an immediate first frame
+}
+
+void frame_request(void) {
+    stats.requests++;
+    if (!pending) {
+        pending = 1;
+        pending_slot = current_slot();
+    }
+}
+
+int frame_due(void) {
+    return pending && (!have_frame || current_slot() > last_slot);
+}
+
+void frame_begin(void) {
+    uint64_t slot = current_slot();
+    // Every slot between the request and now that passed without a frame
+    if (have_frame) {
+        uint64_t first_free = pending_slot > last_slot ? pending_slot : last_slot + 1;
+        if (slot > first_free) stats.dropped += slot - first_free;
+    }
+
+    pending = 0;
+    last_slot = slot;
+    have_frame = 1;
+    frame_start_tsc = rdtsc();
+}
+
+void frame_end(void) {
+    stats.frames++;
+    uint64_t per_us = tsc_per_us();
+    if (per_us == 0) return; // TSC not calibrated yet (first tick)
+
+    uint32_t us = (uint32_t)((rdtsc() - frame_start_tsc) / per_us);
+    stats.last_us = us;
+    stats.avg_us = (stats.avg_us == 0) ? us : stats.avg_us - stats.avg_us / 16 + us / 16;
+    if (us > stats.max_us) stats.max_us = us;
+}
+
+struct FrameStats frame_scheduler_get_stats(void) {
+    return stats;
+}
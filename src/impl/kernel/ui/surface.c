@@ -0,0 +1,97 @@
+#include "ui/surface.h"
+#include "mm/vmm.h"
+
+#define SURFACE_PAGE_SIZE  65536
+#define SURFACE_SCREENS    3    // full-screen surfaces the arena must hold
+#define SURFACE_MAX_PAGES  4096 // bitmap capacity, 256 MiB of arena
+
+// Demand-zero region sized from the mode on first use: only the pages a
+// surface draws into take RAM, and destroyed surfaces give theirs back
+static uint8_t* arena = 0;
+static uint32_t arena_pages = 0;
+static uint64_t page_used[SURFACE_MAX_PAGES / 64];
+static struct Surface surfaces[SURFACE_MAX];
+
+static int arena_init(void) {
+    uint64_t pitch = ((uint64_t)fb.width * framebuffer_pixel_format()->bytes + 3) & ~3ull;
+    // Plus a page per surface for rounding each one up to whole pages
+    uint64_t bytes = SURFACE_SCREENS * pitch * fb.height + (uint64_t)SURFACE_MAX * SURFACE_PAGE_SIZE;
+    uint64_t pages = (bytes + SURFACE_PAGE_SIZE - 1) / SURFACE_PAGE_SIZE;
+    if (pages > SURFACE_MAX_PAGES) pages = SURFACE_MAX_PAGES;
+    arena = (uint8_t*)vmm_reserve(pages * SURFACE_PAGE_SIZE);
+    if (!arena) return 0;
+    arena_pages = (uint32_t)pages;
+    return 1;
+}
+
+static int page_is_used(uint32_t p) {
+    return (page_used[p / 64] >> (p % 64)) & 1;
+}
+
+static void page_set(uint32_t first, uint32_t count, int used) {
+    for (uint32_t p = first; p < first + count; p++) {
+        if (used) page_used[p / 64] |= 1ull << (p % 64);
+        else page_used[p / 64] &= ~(1ull << (p % 64));
+    }
+}
+
+// First fit over the page bitmap; returns arena_pages if nothing fits
+static uint32_t pages_alloc(uint32_t count) {
+    uint32_t run = 0;
+    for (uint32_t p = 0; p < arena_pages; p++) {
+        run = page_is_used(p) ? 0 : run + 1;
+        if (run == count) {
+            page_set(p + 1 - count, count, 1);
+            return p + 1 - count;
+        }
+    }
+    return arena_pages;
+}
+
+struct Surface* surface_create(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0 || fb.base_address == 0) return 0;
+    if (!arena && !arena_init()) return 0;
+
+    struct Surface* s = 0;
+    for (int i = 0; i < SURFACE_MAX; i++) {
+        if (!surfaces[i].in_use) {
+            s = &surfaces[i];
+            break;
+        }
+    }
+    if (!s) return 0;
+
+    // Rows start dword aligned so the span kernels see the same alignment
+    uint32_t pitch = (width * framebuffer_pixel_format()->bytes + 3) & ~3u;
+    uint64_t bytes = (uint64_t)pitch * height;
+    uint32_t count = (uint32_t)((bytes + SURFACE_PAGE_SIZE - 1) / SURFACE_PAGE_SIZE);
+    uint32_t first = pages_alloc(count);
+    if (first == arena_pages) return 0;
+
+    s->target.pixels = arena + (uint64_t)first * SURFACE_PAGE_SIZE;
+    s->target.pitch = pitch;
+    s->target.x = x;
+    s->target.y = y;
+    s->target.width = width;
+    s->target.height = height;
+    s->target.dirty.w = 0;
+    s->target.dirty.h = 0;
+    s->first_page = first;
+    s->page_count = count;
+    s->in_use = 1;
+    s->visible = 1;
+    s->exposed = 1;
+    return s;
+}
+
+void surface_destroy(struct Surface* s) {
+    if (!s || !s->in_use) return;
+    vmm_discard(arena + (uint64_t)s->first_page * SURFACE_PAGE_SIZE,
+                (uint64_t)s->page_count * SURFACE_PAGE_SIZE);
+    page_set(s->first_page, s->page_count, 0);
+    s->in_use = 0;
+}
+
+void surface_bind(struct Surface* s) {
+    framebuffer_bind_target(s ? &s->target : 0);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx);
+uint64_t rdtsc();
+uint64_t rdmsr(uint32_t msr);
+void wrmsr(uint32_t msr, uint64_t value);
+uint64_t read_cr0();
+void write_cr0(uint64_t value);
+uint64_t read_cr2();
+uint64_t read_cr3();
+void write_cr3(uint64_t value);
+uint64_t read_cr4();
+void write_cr4(uint64_t value);
+uint64_t xgetbv(uint32_t index);
+void xsetbv(uint32_t index, uint64_t value);
+void invlpg(uint64_t addr);
+void wbinvd();
@@ -8,6 +8,9 @@ struct registers {
     uint64_t rip, cs, rflags, rsp, ss;
 };
 
+// The entry stubs (interrupts.asm) save general registers only. Everything a
+// handler can reach is built with -mgeneral-regs-only (see the Makefile's
+// interrupt_path_files), since simd_init() enables SSE/AVX for the kernel.
 void isr_handler(struct registers* regs);
 void irq_handler(struct registers* regs);
 void register_interrupt_handler(uint8_t n, void (*handler)(struct registers*));
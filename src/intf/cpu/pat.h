@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+int pat_init();
+void pat_map_write_combining(uint64_t phys_addr, uint64_t size);
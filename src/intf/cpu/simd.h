@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+
+// Vector extensions usable by the kernel (set by simd_init)
+#define SIMD_SSE2 (1 << 0)
+#define SIMD_AVX  (1 << 1)
+#define SIMD_AVX2 (1 << 2)
+
+extern uint32_t simd_features;
+
+// Enables SSE (and AVX when the CPU supports XSAVE) in CR0/CR4/XCR0.
+// The interrupt stubs do not save vector registers, so interrupt handlers
+// must stay integer-only.
+void simd_init();
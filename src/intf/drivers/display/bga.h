@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// Bochs Graphics Adapter (QEMU -vga std / Bochs) via the VBE DISPI ports
+
+// Probe the DISPI interface; returns 1 if a BGA is present
+int bga_init();
+int bga_available();
+uint32_t bga_vram_size();
+
+void bga_set_mode(uint32_t width, uint32_t height, uint32_t bpp);
+// Returns 1 if the adapter accepted the virtual resolution
+int bga_set_virtual(uint32_t virt_width, uint32_t virt_height);
+void bga_set_y_offset(uint32_t y);
+void bga_wait_vblank();
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// Premultiplied-alpha "source over" kernels, selected at runtime by
+// blend_init() (scalar/SSE2/AVX2). Sources are premultiplied 0xAARRGGBB;
+// every byte lane is blended the same way, so any 32-bit layout works as
+// long as the source alpha sits in bits 24..31:
+//     dst = src + dst * (255 - src_alpha) / 255
+
+// Blend one constant premultiplied color over count pixels
+extern void (*blend_fill32)(uint32_t* dst, uint32_t src, uint32_t count);
+// Blend count premultiplied source pixels (fully opaque/transparent runs
+// of 4 or 8 degrade to a copy or a skip)
+extern void (*blend_span32)(uint32_t* dst, const uint32_t* src, uint32_t count);
+
+// Straight 0xAARRGGBB -> premultiplied
+uint32_t blend_premultiply(uint32_t argb);
+// One premultiplied source over one pixel (used by the 16/24 bpp fallbacks)
+uint32_t blend_over(uint32_t dst, uint32_t src);
+
+void blend_init();
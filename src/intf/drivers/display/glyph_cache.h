@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+// Cache of pre-rendered scaled glyph tiles, keyed by (char, scale, fg, bg).
+// Tiles are (8*scale) x (8*scale) pixels in the framebuffer's native format
+// with a stride of 8*scale pixels.
+#define GLYPH_CACHE_MAX_SCALE 4
+
+struct GlyphCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+};
+
+// Returns the tile, or 0 if the glyph cannot be cached
+// (transparent background or scale above GLYPH_CACHE_MAX_SCALE).
+const uint8_t* glyph_cache_get(char c, int scale, uint32_t fg, uint32_t bg);
+struct GlyphCacheStats glyph_cache_get_stats();
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// Streaming decoders for QOI and uncompressed BMP (24/32 bpp). Images are
+// decoded one row at a time into a caller-supplied row of straight
+// 0xAARRGGBB pixels, so no full-size intermediate buffer is needed.
+
+#define IMAGE_MAX_WIDTH 4096
+
+#define IMAGE_QOI 1
+#define IMAGE_BMP 2
+
+struct ImageDecoder {
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t width;
+    uint32_t height;
+    uint8_t format;     // IMAGE_QOI / IMAGE_BMP
+    uint8_t has_alpha;  // 0: alpha bytes of decoded rows are undefined
+    uint32_t row;       // next row to decode (top to bottom)
+    uint32_t pos;       // read offset into data
+
+    // QOI stream state
+    uint32_t px;
+    uint32_t run;
+    uint32_t index[64];
+
+    // BMP layout
+    uint32_t bmp_stride;
+    uint8_t bmp_bpp;
+    uint8_t bmp_bottom_up;
+};
+
+// Parse the header; returns 1 if the image is a supported QOI/BMP
+int image_open(struct ImageDecoder* dec, const void* data, uint32_t size);
+
+// Decode the next row (width pixels). Returns the row: either `row`, or for
+// 32 bpp BMP with 4-byte aligned rows a pointer straight into the source
+// data. 0 when the image is exhausted or truncated.
+const uint32_t* image_next_row(struct ImageDecoder* dec, uint32_t* row);
+
+// Decode an image into the bound render target with its top-left corner at
+// (x, y), clipped; images with alpha are blended. Returns 0 on a bad image.
+int image_draw(const void* data, uint32_t size, int32_t x, int32_t y);
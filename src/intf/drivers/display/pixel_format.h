@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+
+// Pixel layout reported by the multiboot2 framebuffer tag (direct RGB only)
+struct PixelFormat {
+    uint8_t bpp;
+    uint8_t bytes;      // bytes per pixel (2, 3 or 4)
+    uint8_t red_pos;
+    uint8_t red_size;
+    uint8_t green_pos;
+    uint8_t green_size;
+    uint8_t blue_pos;
+    uint8_t blue_size;
+};
+
+// Render routines for one storage size. Colors passed to fill/glyph are
+// already packed with pixel_pack(), so the inner loops never convert.
+// Pointers are byte addresses, counts are in pixels.
+struct PixelOps {
+    const char* name;
+    void (*fill)(uint8_t* dst, uint32_t color, uint32_t count);
+    void (*copy)(uint8_t* dst, const uint8_t* src, uint32_t count);
+    // Non-temporal copy to VRAM; fence with span_stream_fence()
+    void (*stream)(uint8_t* dst, const uint8_t* src, uint32_t count);
+    // Expand one 8x8 font row (MSB = leftmost pixel); _fg leaves clear bits alone
+    void (*glyph8)(uint8_t* dst, uint8_t bits, uint32_t fg, uint32_t bg);
+    void (*glyph8_fg)(uint8_t* dst, uint8_t bits, uint32_t fg);
+};
+
+// Default layout: 32 bpp xRGB8888
+extern const struct PixelFormat pixel_format_xrgb8888;
+
+// Returns 1 and fills *fmt if the layout is one we can render
+int pixel_format_from_tag(struct PixelFormat* fmt, uint8_t bpp,
+                          uint8_t red_pos, uint8_t red_size,
+                          uint8_t green_pos, uint8_t green_size,
+                          uint8_t blue_pos, uint8_t blue_size);
+const struct PixelOps* pixel_format_ops(const struct PixelFormat* fmt);
+
+// Convert between 0xAARRGGBB and the native layout (once per primitive)
+uint32_t pixel_pack(const struct PixelFormat* fmt, uint32_t argb);
+uint32_t pixel_unpack(const struct PixelFormat* fmt, uint32_t native);
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+
+// Span rasterizer for vector primitives. Every shape is broken into
+// horizontal spans that go through one clipped fill routine, and the
+// shape's bounding box is marked dirty once at the end.
+//
+// Polygon vertices and rect edges lie on pixel corners; circle centres are
+// pixel centres, so a radius r circle is 2r + 1 pixels across.
+// With RASTER_AA, edge pixels are blended by coverage (4 sub-scanlines,
+// 1/16 pixel horizontally); interior spans are still solid fills.
+
+#define RASTER_AA 1
+
+#define RASTER_MAX_POINTS 32
+
+// Bresenham line including both end points (AA: 1 pixel wide quad)
+void raster_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color, int flags);
+// stroke == 0: filled disc; otherwise a ring stroke pixels thick
+void raster_circle(int32_t cx, int32_t cy, int32_t r, int32_t stroke, uint32_t color, int flags);
+void raster_round_rect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t radius, uint32_t color, int flags);
+// Even-odd fill of n (x, y) pairs (n <= RASTER_MAX_POINTS)
+void raster_polygon(const int32_t* xy, uint32_t n, uint32_t color, int flags);
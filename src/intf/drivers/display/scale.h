@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// 2D image resampling of 0xAARRGGBB pixels (e.g. an image_next_row()
+// decoded wallpaper scaled to fb.width x fb.height). Column positions and
+// weights are computed once per (source width, destination width, filter)
+// and reused until one of them changes. Strides are in pixels.
+
+#define SCALE_NEAREST  0
+#define SCALE_BILINEAR 1
+
+#define SCALE_MAX_WIDTH 4096 // destination width limit
+
+// Resample into a pixel buffer; returns 0 if the sizes are unsupported
+int scale_image(const uint32_t* src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+                uint32_t* dst, uint32_t dst_w, uint32_t dst_h, uint32_t dst_stride, int filter);
+
+// Resample straight into the bound render target at (x, y), one row at a
+// time through framebuffer_draw_row() (alpha is ignored)
+int scale_draw(const uint32_t* src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+               int32_t x, int32_t y, uint32_t dst_w, uint32_t dst_h, int filter);
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// Pixel span kernels, selected at runtime by span_init() (scalar/SSE2/AVX2).
+// span_fill32/span_copy32 target cached RAM (back buffer), span_stream32 uses
+// non-temporal stores for VRAM; call span_stream_fence() after a flush.
+extern void (*span_fill32)(uint32_t* dst, uint32_t color, uint32_t count);
+extern void (*span_copy32)(uint32_t* dst, const uint32_t* src, uint32_t count);
+extern void (*span_stream32)(uint32_t* dst, const uint32_t* src, uint32_t count);
+
+// Expand one 8x8 font row (MSB = leftmost pixel) into 8 pixels.
+// span_glyph8 writes bg for clear bits, span_glyph8_fg leaves them untouched.
+extern void (*span_glyph8)(uint32_t* dst, uint8_t bits, uint32_t fg, uint32_t bg);
+extern void (*span_glyph8_fg)(uint32_t* dst, uint8_t bits, uint32_t fg);
+
+// 64-bit hash of count pixels, chained through seed; never returns 0
+uint64_t span_hash32(const uint32_t* src, uint32_t count, uint64_t seed);
+
+void span_init();
+void span_stream_fence();
+const char* span_backend_name();
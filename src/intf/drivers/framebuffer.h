@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <stddef.h>
+#include "drivers/display/pixel_format.h"
 
 struct Framebuffer {
     void* base_address;
@@ -11,13 +12,64 @@ struct Framebuffer {
     uint8_t bpp;
 };
 
+// Screen-space rectangle (damage tracking, clipping)
+struct FbRect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t w;
+    uint32_t h;
+};
+
+// Off-screen render target (see ui/surface.h): native-format pixels placed
+// at (x, y) in screen space
+struct FbTarget {
+    uint8_t* pixels;
+    uint32_t pitch;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+    struct FbRect dirty; // screen-space bounds drawn since last compose (w == 0: clean)
+};
+
+// Flush statistics (tiles copied to VRAM vs. skipped as unchanged)
+struct FbStats {
+    uint64_t tiles_flushed;
+    uint64_t tiles_skipped;
+    uint64_t page_flips;
+};
+
 extern struct Framebuffer fb;
 
 void framebuffer_init(void* multiboot_tag);
+void framebuffer_set_clip(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+void framebuffer_reset_clip(void);
+struct FbRect framebuffer_get_clip(void);
+void framebuffer_push_clip(int32_t x, int32_t y, int32_t w, int32_t h);
+void framebuffer_pop_clip(void);
+int framebuffer_clip_rejects(int32_t x, int32_t y, int32_t w, int32_t h);
 void framebuffer_put_pixel(uint32_t x, uint32_t y, uint32_t color);
 uint32_t framebuffer_get_pixel(uint32_t x, uint32_t y);
 void framebuffer_clear(uint32_t color);
 void framebuffer_draw_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color);
-void framebuffer_draw_cursor(uint32_t x, uint32_t y);
+void framebuffer_draw_row(int32_t x, int32_t y, const uint32_t* argb, uint32_t count);
+// Alpha blending (see drivers/display/blend.h): blend_rect takes a straight
+// 0xAARRGGBB color, blend_bitmap premultiplied pixels
+void framebuffer_blend_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t argb);
+void framebuffer_blend_bitmap(const uint32_t* pixels, int32_t x, int32_t y, uint32_t w, uint32_t h, uint32_t stride);
+void framebuffer_scroll_region(uint32_t x, uint32_t y, uint32_t w, uint32_t h, int32_t dy);
+void framebuffer_set_cursor(uint32_t x, uint32_t y, int visible);
+uint8_t* framebuffer_back_pixel(uint32_t x, uint32_t y);
+// Blend a premultiplied color over count pixels at framebuffer_back_pixel()
+void framebuffer_blend_native(uint8_t* dst, uint32_t premul, uint32_t count);
+const struct PixelOps* framebuffer_pixel_ops(void);
+const struct PixelFormat* framebuffer_pixel_format(void);
+uint32_t framebuffer_pack_color(uint32_t argb);
+void framebuffer_mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+void framebuffer_bind_target(struct FbTarget* t);
+void framebuffer_compose(const struct FbTarget* src, uint32_t x, uint32_t y, uint32_t w, uint32_t h);
 void framebuffer_swap(void);
+int framebuffer_enable_page_flip(void);
 void framebuffer_blit_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+uint32_t framebuffer_measure_bandwidth(void);
+struct FbStats framebuffer_get_stats(void);
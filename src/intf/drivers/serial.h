@@ -0,0 +1,8 @@
+#pragma once
+#include <stdint.h>
+
+void serial_init();
+void serial_write_char(char c);
+void serial_write_str(const char* str);
+void serial_write_dec(uint64_t value);
+void serial_write_hex(uint64_t value);
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Bump allocator for short-lived scratch memory. Allocation moves a cursor
+// and nothing is freed individually: arena_mark()/arena_reset_to() roll the
+// cursor back to an earlier point, and scopes nest the same way. Not
+// interrupt safe.
+
+#define ARENA_ALIGN 16
+
+struct Arena {
+    uint8_t* base;
+    size_t size;
+    size_t used;
+    size_t peak;   // high-water mark since init
+};
+
+struct ArenaScope {
+    struct Arena* arena;
+    size_t mark;
+};
+
+void arena_init(struct Arena* a, void* mem, size_t size);
+
+// ARENA_ALIGN-aligned, uninitialized; 0 when the arena is full
+void* arena_alloc(struct Arena* a, size_t size);
+void* arena_zalloc(struct Arena* a, size_t size);
+
+size_t arena_mark(const struct Arena* a);
+// Frees everything allocated since mark; marks past the cursor are ignored,
+// so an inner scope ending after an outer reset is harmless
+void arena_reset_to(struct Arena* a, size_t mark);
+void arena_reset(struct Arena* a);
+
+struct ArenaScope arena_scope_begin(struct Arena* a);
+void arena_scope_end(struct ArenaScope* scope);
+
+// Scratch for the UI frame and for request handlers. Reset after every
+// frame; a handler that runs between frames brackets its use in a scope.
+#define FRAME_ARENA_SIZE (64 * 1024)
+extern struct Arena frame_arena;
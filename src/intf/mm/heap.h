@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Kernel heap on top of the page allocator (mm/pmm.h). Small objects come
+// from slab caches: one page per slab, carved into equal objects. kmalloc()
+// uses power-of-two caches from 16 to KMEM_MAX_OBJECT bytes; subsystems with
+// a hot object type create their own cache. Larger requests take whole
+// page blocks (up to 2 MiB).
+//
+// Each CPU has a magazine of free objects per cache, so the common alloc/free
+// touches no shared state; the cache lock is only taken to refill or drain a
+// magazine. Not for use from interrupt handlers.
+
+#define KMEM_MAX_OBJECT 1024
+#define KMEM_MAX_CACHES 24
+#define KMEM_MAGAZINE   16
+#define KMEM_MAX_CPUS   8
+
+struct KmemStats {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t magazine_hits;  // allocs/frees served without the cache lock
+    uint64_t slabs;          // slabs currently held
+    uint64_t objects_in_use;
+};
+
+struct KmemCache;
+
+void kmem_init(void);
+
+// Object-specific cache (size <= KMEM_MAX_OBJECT); 0 if the table is full
+struct KmemCache* kmem_cache_create(const char* name, uint32_t size);
+void* kmem_cache_alloc(struct KmemCache* cache);
+void kmem_cache_free(struct KmemCache* cache, void* obj);
+
+// Power-of-two sized allocations; kfree() accepts 0
+void* kmalloc(size_t size);
+void* kzalloc(size_t size);
+void kfree(void* ptr);
+
+// Statistics, by cache index (0 .. kmem_cache_count() - 1)
+uint32_t kmem_cache_count(void);
+const char* kmem_cache_name(uint32_t index);
+struct KmemStats kmem_cache_get_stats(uint32_t index);
+// Pages held by kmalloc() allocations above KMEM_MAX_OBJECT
+uint64_t kmem_large_pages(void);
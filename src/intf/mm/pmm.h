@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Buddy allocator for physical pages, built from the multiboot2 memory map.
+// Blocks are 2^order pages, from 4 KiB (order 0) to 2 MiB (PMM_MAX_ORDER).
+// Only memory below 4 GiB is managed: the boot page tables identity-map
+// exactly that much, so a block's physical address is also its pointer.
+// Not interrupt safe.
+
+#define PMM_PAGE_SIZE 4096
+#define PMM_MAX_ORDER 9
+
+struct PmmStats {
+    uint64_t total_pages;   // usable pages handed to the allocator
+    uint64_t free_pages;
+    uint64_t reserved_pages; // usable per the map, but kernel/boot data
+    uint64_t free_blocks[PMM_MAX_ORDER + 1];
+};
+
+// Reserves the kernel image (boot page tables and stack included), the
+// first 1 MiB, the multiboot information and the framebuffer
+void pmm_init(void* multiboot_info);
+
+// Physical address of a 2^order page block, 0 when out of memory
+uint64_t pmm_alloc(uint32_t order);
+void pmm_free(uint64_t addr, uint32_t order);
+
+// Smallest order whose block holds bytes (PMM_MAX_ORDER + 1 if none does)
+uint32_t pmm_order_for(size_t bytes);
+
+struct PmmStats pmm_get_stats(void);
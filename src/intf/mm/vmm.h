@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Virtual memory manager. Adopts the PML4 built by the boot code (an
+// identity map of the first 4 GiB in 2 MiB pages) and edits it in place.
+// Ranges are mapped with the largest page that fits their alignment:
+// 1 GiB where the CPU supports it, then 2 MiB, then 4 KiB. Huge pages are
+// split when part of one changes; emptied tables are kept. Page tables come
+// from the page allocator, so vmm_init() must follow pmm_init(). Not
+// interrupt safe, and TLB invalidation is local: there are no other CPUs to
+// shoot down yet.
+
+#define VMM_PAGE_SIZE 0x1000ull
+#define VMM_PAGE_2M   0x200000ull
+#define VMM_PAGE_1G   0x40000000ull
+
+// Cache attributes, selected through PWT/PCD with the PAT layout set up by
+// pat_init() (cpu/pat.h). Without pat_init() VMM_CACHE_WC is write-through.
+#define VMM_CACHE_WB       0
+#define VMM_CACHE_WC       1
+#define VMM_CACHE_UC_MINUS 2
+#define VMM_CACHE_UC       3
+
+// vmm_map() flags: a cache attribute plus
+#define VMM_WRITE 0x10
+
+void vmm_init(void);
+int vmm_has_1g_pages(void);
+
+// Map [virt, virt + size) to phys; addresses and size must be 4 KiB aligned.
+// Existing mappings in the range are replaced. Returns 1, or 0 when page
+// tables ran out (the range may then be partly mapped).
+int vmm_map(uint64_t virt, uint64_t phys, uint64_t size, uint32_t flags);
+// Remove mappings in [virt, virt + size); unmapped parts are skipped
+int vmm_unmap(uint64_t virt, uint64_t size);
+// Change the cache attribute of mapped pages in [virt, virt + size)
+int vmm_set_cache(uint64_t virt, uint64_t size, uint32_t cache);
+
+// Identity-map device memory (MMIO, VRAM, 64-bit BARs) with the given cache
+// attribute, rounded out to 4 KiB. Returns the pointer, 0 on failure.
+void* vmm_map_device(uint64_t phys, uint64_t size, uint32_t cache);
+
+// Physical address behind virt, 0 if unmapped
+uint64_t vmm_translate(uint64_t virt);
+
+// Demand-zero regions. vmm_reserve() hands out virtual space above the
+// identity map without backing it; the page-fault handler maps a zeroed page
+// on first touch, so a region costs only the RAM actually used. Touch regions
+// from normal kernel code only, never from an interrupt handler: resolving
+// the fault allocates frames and page tables.
+#define VMM_DEMAND_BASE 0x0000010000000000ull // 1 TiB, PML4 entry 2
+#define VMM_MAX_REGIONS 16
+
+// Reserve size bytes (rounded up to pages), 0 when the region table is full
+void* vmm_reserve(uint64_t size);
+// Give the pages touched in [addr, addr + size) back to the page allocator;
+// the range stays reserved and reads as zero again
+void vmm_discard(void* addr, uint64_t size);
+// Discard a whole region and end its reservation
+void vmm_release(void* addr);
+
+// Resolve a #PF at fault_addr; 1 if it hit a reserved page and is now mapped
+int vmm_handle_fault(uint64_t fault_addr, uint64_t err_code);
+// Pages currently backing demand-zero regions
+uint64_t vmm_demand_pages(void);
@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// Images shipped inside the kernel as QOI assets, decoded once at boot into
+// premultiplied pixels for dl_draw_image() and scaled to the current mode.
+// assets_init() needs framebuffer_init() and kmem_init().
+
+struct UiImage {
+    const uint32_t* pixels; // premultiplied 0xAARRGGBB, stride = width
+    uint32_t width;         // 0 if the asset failed to decode
+    uint32_t height;
+};
+
+void assets_init(void);
+const struct UiImage* assets_logo(void);
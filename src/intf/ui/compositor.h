@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include "ui/surface.h"
+
+// Z-ordered surface compositor. compositor_compose() copies the changed
+// parts of each surface into the screen back buffer, skipping whatever is
+// hidden behind surfaces above it.
+
+struct CompositorStats {
+    uint64_t rects;          // rectangles copied
+    uint64_t pixels;         // pixels copied
+    uint64_t culled_pixels;  // damaged pixels skipped as occluded
+};
+
+// Add on top of the stack
+void compositor_add(struct Surface* s);
+void compositor_remove(struct Surface* s);
+void compositor_raise(struct Surface* s);
+void compositor_set_visible(struct Surface* s, int visible);
+// Color shown where no visible surface covers the screen
+void compositor_set_background(uint32_t color);
+void compositor_compose(void);
+struct CompositorStats compositor_get_stats(void);
@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+
+// Retained display list: a view records its primitives every frame with the
+// dl_draw_* calls; display_list_end() diffs them against the previous frame
+// and rasterizes only the regions whose primitives changed.
+
+#define DL_RECT        1
+#define DL_TEXT        2
+#define DL_TEXT_SCALED 3
+#define DL_CHAR        4
+// Vector shapes (drivers/display/raster.h)
+#define DL_LINE        5
+#define DL_CIRCLE      6
+#define DL_ROUND_RECT  7
+#define DL_POLYGON     8
+// Premultiplied pixels drawn from caller memory
+#define DL_IMAGE       9
+
+struct DlPrim {
+    uint8_t type;
+    uint8_t scale;     // text scale, or RASTER_* flags for shapes
+    uint16_t len;      // text length (DL_TEXT*), or point bytes (DL_LINE/DL_POLYGON)
+    int32_t x, y;
+    int32_t w, h;      // bounds
+    uint32_t fg;       // rect color / text color / shape color
+    uint32_t bg;       // text background, circle stroke or corner radius
+                       // (DL_IMAGE: the pixel pointer, low half in fg)
+    uint32_t text;     // offset into the frame's text pool, or the char (DL_CHAR).
+                       // Shape points are stored there as int16 pairs relative to (x, y)
+    uint64_t hash;
+};
+
+// Extra damage recorded outside the diff (e.g. by display_list_scroll)
+#define DL_MAX_PENDING 8
+struct DlBox {
+    int32_t x, y, w, h;
+};
+
+struct DlFrame {
+    struct DlPrim* prims;
+    uint32_t count;
+    char* text;
+    uint32_t text_used;
+};
+
+struct DisplayList {
+    struct DlFrame frames[2];  // [cur], [cur ^ 1] = previous frame
+    uint32_t cur;
+    uint32_t prim_capacity;    // per frame
+    uint32_t text_capacity;    // per frame
+    int overflow;              // recording fell back to immediate drawing
+    int prev_valid;            // previous frame matches what is on screen
+    struct DlBox pending[DL_MAX_PENDING]; // damage carried into the next display_list_end
+    uint32_t pending_count;
+};
+
+// prim_storage holds 2 * prim_capacity entries, text_storage 2 * text_capacity bytes
+void display_list_init(struct DisplayList* dl, struct DlPrim* prim_storage, uint32_t prim_capacity,
+                       char* text_storage, uint32_t text_capacity);
+void display_list_begin(struct DisplayList* dl);
+void display_list_end(struct DisplayList* dl);
+void display_list_invalidate(struct DisplayList* dl);
+// Scroll the on-screen contents of a rect by dy rows with one bulk move and
+// shift the retained primitives to match, so the next frame only redraws
+// what scrolled in. Call between frames; returns 0 if the list cannot
+// follow (nothing retained), in which case nothing is moved.
+int display_list_scroll(struct DisplayList* dl, int x, int y, int w, int h, int dy);
+
+// Record into the list passed to display_list_begin (or draw immediately if none)
+void dl_draw_rect(int x, int y, int w, int h, uint32_t color);
+void dl_draw_string(const char* str, int x, int y, uint32_t fg, uint32_t bg);
+void dl_draw_string_scaled(const char* str, int x, int y, uint32_t fg, uint32_t bg, int scale);
+void dl_draw_char(char c, int x, int y, uint32_t fg, uint32_t bg);
+void dl_draw_line(int x0, int y0, int x1, int y1, uint32_t color, int flags);
+void dl_draw_circle(int cx, int cy, int r, int stroke, uint32_t color, int flags);
+void dl_draw_round_rect(int x, int y, int w, int h, int radius, uint32_t color, int flags);
+// xy holds n (x, y) pairs, n <= RASTER_MAX_POINTS
+void dl_draw_polygon(const int* xy, int n, uint32_t color, int flags);
+// w x h premultiplied 0xAARRGGBB pixels (stride w), blended. Only the
+// pointer is recorded: the pixels must not change while a frame uses them.
+void dl_draw_image(const uint32_t* pixels, int x, int y, int w, int h);
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// Coalesces redraw requests into at most one frame per refresh interval.
+// Frame slots are derived from the PIT tick count with a fractional
+// accumulator, so rates that do not divide the tick rate still average out.
+
+struct FrameStats {
+    uint64_t frames;      // frames rendered
+    uint64_t requests;    // frame_request() calls (coalesced into frames)
+    uint64_t dropped;     // refresh slots missed while a frame was pending
+    uint32_t last_us;     // render time of the last frame
+    uint32_t avg_us;      // moving average (1/16 weight)
+    uint32_t max_us;
+};
+
+void frame_scheduler_init(uint32_t fps);
+// Something changed; render in the next free refresh slot
+void frame_request(void);
+// A frame is pending and its slot has arrived
+int frame_due(void);
+// Bracket the render to collect timing
+void frame_begin(void);
+void frame_end(void);
+struct FrameStats frame_scheduler_get_stats(void);
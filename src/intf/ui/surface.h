@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include "drivers/framebuffer.h"
+
+// Off-screen surfaces in the framebuffer's native pixel format, carved out
+// of an arena in SURFACE_PAGE_SIZE pages. The arena is a demand-zero region
+// (mm/vmm.h) sized for three full screens of the current mode.
+#define SURFACE_MAX 8
+
+struct Surface {
+    struct FbTarget target; // pixels, screen origin, size, dirty bounds
+    uint32_t first_page;
+    uint32_t page_count;
+    int in_use;
+    int visible;
+    int exposed;            // whole surface must be recomposited
+};
+
+// Returns 0 if the arena or the surface table is exhausted
+struct Surface* surface_create(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+void surface_destroy(struct Surface* s);
+// Draw into s (0 = screen back buffer)
+void surface_bind(struct Surface* s);